@@ -1,6 +1,6 @@
 /* Generation and enumeration of all alkane constitutional isomers from methane to icosane   */
 /* ========================================================================================= */
-/* using an altered canonical isomer code and Morgan's Algorithm                             */
+/* using an altered canonical isomer code and Morgan's Algorithm or exact canonical labeling */
 /*                                                                                           */
 /* by Andreas Gimpel, agimpel@student.ethz.ch                                                */
 /* student of the Department of Chemistry and Applied Biosciences, ETH Zürich                */
@@ -11,19 +11,80 @@
 /*                                                                                           */
 /*                                                                                           */
 /* Using the g++ compiler, the program was compiled with                                     */
-/* g++ -O3 alkane_isomers.cc                                                                 */
+/* g++ -O3 -pthread alkane_isomers.cc                                                        */
+/*                                                                                           */
+/* Options (none of them is required):                                                       */
+/*   --first N, --last N        alkanes printed and written to files (default 1 to 20)       */
+/*   --output text|binary|none  format of the isomer files, or none to write no isomer files.*/
+/*                              Without isomer files, every finished alkane is still saved to*/
+/*                              checkpoint.isomers in --output-dir to resume from            */
+/*   --no-checkpoint            do not write checkpoint.isomers                              */
+/*   --output-dir DIR           directory of the isomer files (default isomer)               */
+/*   --threads N                worker threads, 0 uses every core (default 0)                */
+/*   --resume-from DIR          continue from the largest alkane saved in DIR, either as     */
+/*                              output file or as checkpoint                                 */
+/*   --count-only               compute the amounts of isomers up to countLastCarbon (or     */
+/*                              --last) without generating them. Add --verify to compare     */
+/*                              them with the generated amounts up to icosane                */
+/*   --keys canonical|morgan    judge the uniqueness of isomers by their canonical codes     */
+/*                              (default) or by their Morgan's codes, computed with AVX2 if  */
+/*                              the processor supports it                                    */
+/*   --cross-check              generate every alkane a second time with the other key mode  */
+/*                              and compare the amounts of isomers                           */
+/*   --spill                    keep the previous alkane in a file instead of in memory while*/
+/*                              the next one is generated                                    */
+/*   --engine store|orderly     generate and store every alkane (default), or only count the */
+/*                              isomers with a depth-first walk that keeps no isomers in     */
+/*                              memory. The orderly engine writes no files                   */
+/*   --benchmark                generate the alkanes without writing files and print the     */
+/*                              time and work of every alkane as JSON, checked against the   */
+/*                              amounts of OEIS A000602. Exits with 1 if any amount is wrong */
+/*   --progress                 report the progress of every alkane on stderr once a second  */
+/*   --trace FILE               write the time of every step of every alkane to FILE         */
+/*   --shard I/N                generate alkane --last only from the parents I, I+N, I+2N... */
+/*                              of the previous alkane's isomer file in --output-dir, into a */
+/*                              shard file. Run once for every I from 0 to N-1               */
+/*   --merge-shards N           merge the N shard files of alkane --last into its isomer     */
+/*                              file, identical to the one a single run writes, and remove   */
+/*                              the shard files                                              */
+/*   --descriptors LIST         also write the descriptors in LIST (wiener, randic,          */
+/*                              branching, smiles or all, separated by commas) of every      */
+/*                              generated alkane to [carbon atoms].descriptors.csv           */
+/* Without --output, the program asks whether to write files if it is run from a terminal.   */
 /*                                                                                           */
 /* For an explanation of the algorithms and general structure used, refer to the .pdf.       */
 /* There are many comments in the code which should allow for a basic understanding of the   */
 /* methodology as well as the concept this algorithm employs.                                */
 /*                                                                                           */
-/* NOTE: In order for the file output to work, an (empty) directory isomer/ has to be        */
-/* present in the directory the program is compiled to. It is included in this .zip file.    */
+/* NOTE: In order for the file output to work, an (empty) directory isomer/ (or the one      */
+/* given with --output-dir) has to be present in the directory the program is run in. It is  */
+/* included in this .zip file.                                                               */
 
 
 #include <iostream>                   //iostream for general output and input
-#include <fstream>                    //fstream to create output files with all isomer codes, if user wishes to do so
-#include <vector>                     //vector library to create an array-like structure capable of storing 22x500000x22 entries
+#include <fstream>                    //fstream to create output files with all isomer codes, if user wishes to do so, and to spill the previous alkane's isomers
+#include <cstdio>                     //cstdio to remove the spill file once it is not needed anymore, to rename finished isomer files and to format the Randic index
+#include <cmath>                      //cmath for the square roots of the Randic index
+#include <vector>                     //vector library to create the per-alkane isomer stores, which grow on demand
+#include <iomanip>                    //iomanip to format the optional index statistics of print_Isomers
+#include <thread>                     //thread to generate the isomers of one alkane on several cores
+#include <atomic>                     //atomic to hand out chunks of parent isomers to the worker threads
+#include <mutex>                      //mutex and condition_variable to wake up the progress report once an alkane is finished
+#include <condition_variable>
+#include <functional>                 //function to pass the work of each thread to run_workers
+#include <algorithm>                  //algorithm to sort the children found by a shard and the isomers merged from all shards
+#include <string>                     //string to read the command line options and to print large numbers
+#include <chrono>                     //chrono to time the steps of generate_Isomers
+#include <sys/resource.h>             //resource to read the peak memory use for --benchmark
+#include <cstdlib>                    //cstdlib to read the numbers in the header of text isomer files and in the command line options
+#include <cstring>                    //cstring to copy packed codes out of memory-mapped isomer files
+#include <sys/mman.h>                 //mman, fcntl, stat and unistd to map binary isomer files into memory
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>                   //unistd also tells whether the program is run from a terminal
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>                //immintrin for the AVX2 version of Morgan's algorithm, which is only used if the processor supports it
+#endif
 
 using namespace std;
 
@@ -33,9 +94,207 @@ using namespace std;
 // GLOBAL VARIABLES
 // ==============================================================================================================================================================================================================
 
-const int firstCarbon = 1;            //carbon amount of first alkane, cannot be changed as algorithm is recursive and depends on methane as its base
-const int lastCarbon  = 20;           //amount of carbons the last alkane generated has. Can be changed for debugging purposes. Not tested for >20 (maxIsomers has to be changed for >20)
-const int maxIsomers  = 500000;       //maximum amount of individual isomers that can be stored. This does not include isomers that are ignored due to not being unique
+int firstCarbon = 1;                  //carbon amount of the first alkane printed and written to files. Smaller alkanes are still generated, as the algorithm is recursive and depends on methane as its base
+int lastCarbon  = 20;                 //amount of carbons the last alkane generated has. Can be changed with --last. Cannot be larger than maxCodeCarbons
+const int maxCodeCarbons = 31;        //largest alkane whose isomer code still fits into a single isomer_code (3 bits for the root and 2 bits for every other digit)
+
+const bool compareFullCodes = true;   //if true, a hash match in the Morgan's code index is confirmed by comparing the full codes. If false, equal hashes are trusted to mean equal codes
+const bool indexStatistics  = false;  //if true, the probe and collision counts of the Morgan's code index and the share of candidates rejected by each check are printed next to the amount of isomers
+
+const int morganKeys    = 0;          //uniqueness of isomers is judged by their sorted Morgan's codes (see function morgans_code)
+const int canonicalKeys = 1;          //uniqueness of isomers is judged by their canonical tree codes (see function canonical_code)
+int keyMode = canonicalKeys;          //which of the two codes above is used to judge uniqueness. Can be changed with --keys
+const bool batchMorgans = true;       //if true and the processor supports AVX2, the Morgan's codes of morganLanes candidates are computed at once (see function morgans_code_batch)
+const int morganLanes = 8;            //amount of candidates in one batch, one per 32 bit lane of an AVX2 register
+bool crossCheckKeys = false;          //if true, every alkane is generated a second time with the other key mode and the amounts of isomers are compared. Can be enabled with --cross-check
+
+const int countLastCarbon  = 100;     //amount of carbons of the last alkane whose isomers are counted with --count-only, unless --last is given
+const int countCheckCarbon = 20;      //with --verify, the counts are compared to the generated amounts of isomers up to this alkane
+
+const int storeEngine   = 0;          //isomers are generated level by level from all isomers of the previous alkane, which are kept in memory and written to files (see function generate_Isomers)
+const int orderlyEngine = 1;          //isomers are only counted by a depth-first walk that generates every isomer exactly once and keeps no isomers in memory (see function orderly_generate)
+int engine = storeEngine;             //which of the two engines above is used. Can be changed with --engine
+const int orderlySplitCarbon = 14;    //the orderly engine hands out the isomers of this alkane as starting points to the worker threads
+
+const int textOutput   = 0;           //isomer files list every isomer code as a line of digits
+const int binaryOutput = 1;           //isomer files hold a fixed header followed by the bit-packed isomer codes (see struct isomer_file)
+int outputFormat = textOutput;        //which of the two file formats above is written. Can be changed with --output
+string outputDirectory = "isomer";    //directory all isomer files are written to. Can be changed with --output-dir
+
+bool checkpointLevels = true;         //if true and no output files are generated, every finished alkane is still saved to checkpointFilename in outputDirectory, so that an interrupted run can be resumed.
+                                      //If a checkpoint cannot be written, the run continues without them (see function save_level). Can be disabled with --no-checkpoint
+const string checkpointFilename = "checkpoint.isomers";
+
+bool spillParents = false;            //if true, the previous alkane's isomers are moved to spillFilename in outputDirectory while the current alkane is generated, and read back in waves. If a checkpoint
+                                      //is written, the checkpoint file is used instead of a second copy. Can be enabled with --spill
+const string spillFilename = "parents.spill";
+
+const int wienerDescriptor    = 1;    //descriptors that can be written for every isomer (see function describe_isomer), combined as bits in descriptorSet
+const int randicDescriptor    = 2;
+const int branchingDescriptor = 4;
+const int smilesDescriptor    = 8;
+int descriptorSet = 0;                //descriptors written to [carbon atoms].descriptors.csv in outputDirectory while the alkanes are generated, none if 0. Can be chosen with --descriptors
+
+bool showProgress = false;            //if true, the progress of every alkane is reported on stderr while it is generated (see function report_progress). Can be enabled with --progress
+const int progressSeconds = 1;        //seconds between two progress reports
+string traceFilename = "";            //if not empty, the time of every step of every alkane is written to this file (see function print_trace). Can be set with --trace
+
+int threadCount  = 0;                 //amount of worker threads generating each alkane. 0 uses every core of the system. The generated isomers do not depend on this value. Can be changed with --threads
+const int chunkParents = 64;          //amount of parent isomers a worker thread extends in one go
+const int waveChunks   = 256;         //amount of chunks generated before their candidates are merged into the isomer store
+
+
+
+// ==============================================================================================================================================================================================================
+// DATA STRUCTURES
+// ==============================================================================================================================================================================================================
+
+//isomer_code holds a complete canonical isomer code packed into a single 64 bit word. The root may have up to 4 forward connections and is stored in the lowest 3 bits, every other digit has at most 3
+//forward connections and is stored in the following 2 bit fields, so digit d (d>=2) is found at bit 3+2*(d-2). For icosane, this takes 41 bits. All isomers of one alkane are stored one after another
+//in a single vector<isomer_code>, which only grows as far as isomers are actually found.
+
+typedef unsigned long long isomer_code;
+
+//morgan_index is an open-addressing hash set over the sorted Morgan's codes of the current alkane. Each slot holds the number of an isomer whose code is stored in the morgans vector (-1 marks an empty
+//slot) together with the hash of that code, so that a lookup only has to compare full codes if the hashes are identical. probes counts every slot inspected during lookups and collisions counts the slots
+//whose hash was identical although the full codes were not. filtered counts the slots whose hash was identical, but whose invariants (see function isomer_invariant) already told the codes apart.
+//The remaining counters follow the candidates through the checks of generate_Isomers and are summed up in the statistics of a whole alkane.
+
+struct morgan_index {
+  vector<int> slots;                  //isomer number stored in each slot, -1 if the slot is empty
+  vector<unsigned long long> hashes;  //hash of the Morgan's code stored in each slot
+  int used;                           //amount of occupied slots
+  long long lookups;                  //amount of codes looked up
+  long long probes;                   //amount of slots inspected over all lookups
+  long long collisions;               //amount of identical hashes belonging to different codes
+  long long filtered;                 //amount of identical hashes belonging to different invariants
+  long long duplicates;               //amount of codes looked up that were found in the index
+  long long extensions;               //amount of parent digits tried to be extended
+  long long invalid;                  //amount of extensions rejected by Isomer_digit_validity_check
+  long long merge_duplicates;         //amount of duplicates only found when merging the chunks
+  double generate_seconds;            //time spent generating the chunks, including their keys and the checks within each chunk
+  double key_seconds;                 //time the worker threads spent computing the keys of the candidates, summed over all threads
+  double lookup_seconds;              //time the worker threads spent looking the keys up within their chunks, summed over all threads
+  double merge_seconds;               //time spent checking the candidates against the other chunks
+  double store_seconds;               //time spent appending the unique candidates to the current alkane
+  double describe_seconds;            //time spent computing the descriptors of the unique candidates
+};
+
+//isomer_file gives access to a binary isomer file mapped into memory. A binary isomer file starts with a header of 32 bytes:
+//  bytes  0-7   "ALKANISO"            bytes  8-11  format version (1)          bytes 12-15  carbon atoms of the alkane
+//  bytes 16-23  amount of isomers     bytes 24-27  bits per isomer code        bytes 28-31  unused (0)
+//All numbers are stored with the lowest byte first. The header is followed by the isomer codes in their packed form (see isomer_code), each taking exactly 3+2*(carbons-1) bits. Isomer k starts
+//at bit k*width behind the header, with the lowest bit first, so every isomer can be read directly from the mapped file without reading the ones before it (see function isomer_file_code).
+
+struct isomer_file {
+  int descriptor = -1;                //file descriptor of the mapped file, -1 if no file is open
+  const unsigned char *data = NULL;   //mapped file, NULL if no file is mapped
+  size_t size = 0;                    //size of the mapped file in bytes
+  int carbons;                        //carbon atoms of the alkane
+  long long amount;                   //amount of isomers in the file
+  int width;                          //bits per isomer code
+};
+
+//isomer_level holds all isomers of one alkane. Usually, their codes are kept in memory. If the level was spilled (see function spill_level), codes is empty and the codes are read back from the binary
+//isomer file spill_file, which stays mapped into memory as spill, one wave at a time, so that only the alkane that is being generated has to fit into memory.
+
+struct isomer_level {
+  vector<isomer_code> codes;          //codes of all isomers, unless spilled
+  long long amount;                   //amount of isomers
+  string spill_file;                  //file the codes were spilled to, empty if they are in memory
+  bool keep_spill_file;               //if true, the spill file is the checkpoint and is not removed by release_level
+  isomer_file spill;                  //the mapped spill file, if the level was spilled
+};
+
+//alkane_graph holds the connectivity of one isomer with atoms 1...atoms. As no carbon atom has more than 4 bonds, the neighbors of each atom fit into a fixed array.
+
+struct alkane_graph {
+  int atoms;                                //amount of carbon atoms
+  int degree[maxCodeCarbons+2];             //amount of bonds of every atom
+  int neighbor[maxCodeCarbons+2][4];        //atoms every atom is bonded to
+};
+
+//big_number holds a non-negative integer of any size as a sequence of 32 bit digits, starting with the lowest. It is used to count isomers of alkanes far beyond the range of 64 bit integers.
+
+struct big_number {
+  vector<unsigned int> limbs;         //digits in base 2^32, the lowest first. No leading zero digits are stored, so 0 has no digits at all
+};
+
+//orderly_sibling holds the canonical code of one child accepted by orderly_generate, so that no other child of the same parent with this code is accepted as well
+
+struct orderly_sibling {
+  int code[maxCodeCarbons+1];
+};
+
+//morgan_batch collects up to morganLanes candidates whose Morgan's codes are computed together by morgans_code_batch. network holds the pairs of positions a sorting network for CarbonAmount values
+//compares, see function morgans_network.
+
+struct morgan_batch {
+  alkane_graph graphs[morganLanes];   //connectivity of the candidates
+  isomer_code codes[morganLanes];     //packed codes of the candidates
+  unsigned long long invariants[morganLanes];  //invariants of the candidates
+  int amount;                         //amount of candidates collected so far
+  vector<int> network;                //pairs of positions compared by the sorting network, the larger value goes to the first position
+};
+
+//worker_progress holds the counters a worker thread adds the work of every chunk it generated to, if showProgress is set. Every worker has its own counters on their own cache line, so the threads
+//never write to the same memory and the counters can be read by report_progress at any time.
+
+struct alignas(64) worker_progress {
+  atomic<long long> parents;          //parent isomers extended
+  atomic<long long> extensions;       //extensions tried
+  atomic<long long> invalid;          //extensions rejected by Isomer_digit_validity_check
+  atomic<long long> duplicates;       //candidates found to be duplicates within their chunk
+};
+
+//level_progress holds everything report_progress needs to know about the alkane being generated. The counters of the merged chunks are updated by generate_Isomers after every wave.
+
+struct level_progress {
+  int carbons;                        //carbon atoms of the alkane
+  long long parents;                  //amount of parent isomers
+  vector<worker_progress> workers;    //counters of every worker thread
+  atomic<long long> merge_duplicates; //candidates found to be duplicates of other chunks
+  atomic<long long> stored;           //unique isomers stored so far
+  atomic<long long> used_slots;       //occupied slots of all shard indexes
+  atomic<long long> slots;            //slots of all shard indexes
+  bool done;                          //set once the alkane is finished
+  mutex lock;                         //protects done
+  condition_variable finished;        //notified once done is set
+};
+
+//shard_record holds one child found by shard_Isomers. key is its canonical code (see function canonical_code), packed like an isomer code, which is the same for all identical children and orders the
+//shard files. occurrence is the position at which a single run of generate_Isomers would generate the child: the number of its parent times 32 plus the digit extended, so a smaller occurrence
+//means generated earlier.
+//A shard file starts with a header of 32 bytes, stored with the lowest byte first like the one of binary isomer files:
+//  bytes  0-7   "ALKSHARD"            bytes  8-11  format version (1)          bytes 12-15  carbon atoms of the alkane
+//  bytes 16-23  amount of records     bytes 24-27  number of the shard         bytes 28-31  amount of shards
+//The records follow in the order of their keys, each as its three fields key, occurrence and code, stored in 8 bytes each with the lowest byte first.
+
+struct shard_record {
+  isomer_code key;                    //packed canonical code
+  unsigned long long occurrence;      //parent number*32 + digit extended
+  isomer_code code;                   //isomer code the child was generated as
+};
+
+//chunk_keys holds all candidates of one chunk together with their keys between the two passes of generate_chunk. Every worker thread has its own, which is reused for every chunk it generates.
+
+struct chunk_keys {
+  vector<isomer_code> codes;          //packed codes of the candidates
+  vector<int> keys;                   //invariants and keys of the candidates, CarbonAmount+1 values each
+};
+
+//isomer_chunk holds the candidates a worker thread generated from one chunk of parent isomers. Candidates that are identical to an earlier candidate of the same chunk are already dropped, so codes
+//contains each candidate of this chunk once, in the order in which they were first generated. morgans and hashes hold their keys (see keyMode) and the hashes thereof. Whether a candidate is also
+//unique among all chunks is decided afterwards and stored in unique.
+
+struct isomer_chunk {
+  vector<isomer_code> codes;          //packed codes of the candidates
+  vector<int> morgans;                //invariants and keys of the candidates, CarbonAmount+1 values each
+  vector<unsigned long long> hashes;  //hashes of the keys
+  vector<char> unique;                //1 if the candidate is the first of its kind among all chunks
+  string descriptors;                 //descriptor rows of the unique candidates, if descriptors are written
+  morgan_index index;                 //index to drop duplicates within this chunk
+};
 
 
 
@@ -44,20 +303,123 @@ const int maxIsomers  = 500000;       //maximum amount of individual isomers tha
 // ==============================================================================================================================================================================================================
 
 //generation function group
-void generate_Isomers(vector<vector<vector<int> > > &isomers, int CarbonAmount, int maxIsomers, vector<vector<int> > &morgans);
-int Isomer_digit_validity_check(vector<vector<vector<int> > > &isomers, int previousC, int C, int I, int CarbonAmount); 
+void generate_Isomers(isomer_level &parents, vector<isomer_code> &current, int CarbonAmount, int mode, morgan_index &statistics, ofstream *descriptors);
+void generate_chunk(const isomer_code parents[], int first, int last, int CarbonAmount, int mode, isomer_chunk &chunk, chunk_keys &candidates);
+void merge_shard(vector<isomer_chunk> &chunks, int chunk_amount, int shard, int shards, int CarbonAmount, vector<int> &morgans, morgan_index &index);
+int Isomer_digit_validity_check(isomer_code parent, int C);
+int worker_count();
+void run_workers(int workers, const function<void(int)> &work);
+
+//level function group
+void level_from_codes(isomer_level &level, vector<isomer_code> &codes);
+bool spill_level(isomer_level &level, int CarbonAmount, string filename, bool keep);
+bool save_level(isomer_level &level, int CarbonAmount, bool spill, bool &checkpoint);
+void release_level(isomer_level &level);
+int resume_level(string directory, int last, isomer_level &level, string &filename);
+
+//isomer file function group
+int code_width(int CarbonAmount);
+bool write_binary_isomer_file(const isomer_code codes[], long long amount, int CarbonAmount, string filename);
+bool finish_partial_file(ofstream &file, string partial, string filename);
+bool open_isomer_file(string filename, isomer_file &file);
+isomer_code isomer_file_code(isomer_file &file, long long isomer);
+void close_isomer_file(isomer_file &file);
+int read_isomer_file(string filename, int CarbonAmount, vector<isomer_code> &codes);
+
+//code function group
+int digit_shift(int digit);
+int isomer_digit(isomer_code code, int digit);
+isomer_code isomer_extend(isomer_code parent, int C);
+void isomer_unpack(isomer_code code, int CarbonAmount, int digits[]);
+isomer_code isomer_pack(int digits[], int CarbonAmount);
 
 //examination function group
-int check_Isomers(vector<vector<vector<int> > > &isomers, int isomer, int CarbonAmount, vector<vector<int> > &morgans);
-void morgans_splicing(vector<vector<vector<int> > > &isomers, int isomer, int CarbonAmount, vector<vector<int> > &morgans, vector<vector<int> > &connections);
-void morgans_algorithm(int isomer, int CarbonAmount, vector<vector<int> > &morgans, vector<vector<int> > &connections);
-void morgans_sort(int isomer, int CarbonAmount, vector<vector<int> > &morgans);
-int check_morgan_uniqueness(int isomer, int CarbonAmount, vector<vector<int> > &morgans);
+void isomer_key(alkane_graph &graph, unsigned long long invariant, int mode, int morgan[]);
+void morgans_code(alkane_graph &graph, int morgan[]);
+void morgans_algorithm(alkane_graph &graph, int morgan[]);
+void morgans_sort(int CarbonAmount, int morgan[]);
+void isomer_key_batch(morgan_batch &batch, int CarbonAmount, chunk_keys &candidates);
+void morgans_code_batch(morgan_batch &batch, int CarbonAmount, int keys[][maxCodeCarbons+2]);
+void morgans_network(int CarbonAmount, vector<int> &network);
+bool morgans_batch_supported();
+int check_morgan_uniqueness(int morgan[], unsigned long long hash, int CarbonAmount, vector<int> &morgans, morgan_index &index);
+unsigned long long isomer_invariant(alkane_graph &graph);
+unsigned long long invariant_add_leaf(unsigned long long invariant, alkane_graph &parent, int C);
+void invariant_change(unsigned long long &invariant, int first, int second, int change);
+
+//canonical function group
+void canonical_code(alkane_graph &graph, int canonical[]);
+void code_to_graph(isomer_code code, int CarbonAmount, alkane_graph &graph);
+void graph_add_leaf(alkane_graph &parent, int C, alkane_graph &child);
+int graph_centers(alkane_graph &graph, int centers[]);
+int canonical_subtree(alkane_graph &graph, int atom, int parent, int code[]);
+int compare_codes(int first[], int second[], int length);
+
+//orderly function group
+void orderly_Isomers();
+void orderly_generate(alkane_graph &graph, int last, vector<long long> &counts, vector<alkane_graph> *starts, int start_carbon);
+int orderly_check_leaf(alkane_graph &graph, int leaf, int canonical[]);
+int orderly_subtree(alkane_graph &graph, int atom, int parent, int distance[], int height, int leaf, int code[], int &has_deepest, int &is_last);
+
+//descriptor function group
+void describe_isomer(alkane_graph &graph, isomer_code code, string &row);
+int wiener_index(alkane_graph &graph);
+double randic_index(alkane_graph &graph);
+void smiles_branch(alkane_graph &graph, int atom, int parent, string &smiles);
+bool read_descriptor_set(string list, int &set);
+bool open_descriptor_file(ofstream &file, string filename);
+bool close_descriptor_file(ofstream &file, string filename);
+bool write_descriptor_file(vector<isomer_code> &codes, int CarbonAmount, string filename);
+string descriptor_filename(string directory, int CarbonAmount);
+
+//shard function group
+int shard_Isomers(int shard, int shards);
+int merge_Isomers(int shards);
+void compact_records(vector<shard_record> &records);
+bool write_shard_file(vector<shard_record> &records, int CarbonAmount, int shard, int shards, string filename);
+bool open_shard_file(string filename, int CarbonAmount, int shard, int shards, ifstream &file, long long &amount);
+bool read_shard_record(ifstream &file, shard_record &record);
+string shard_filename(string directory, int CarbonAmount, int shard, int shards);
+
+//progress function group
+void report_progress(level_progress &progress);
+void print_trace(ofstream &trace, int CarbonAmount, long long amount, morgan_index &statistics, double seconds);
+
+//benchmark function group
+int benchmark_Isomers();
+double seconds_since(chrono::steady_clock::time_point start);
+long peak_memory();
+
+//count function group
+bool count_Isomers(bool verify);
+void count_rooted_trees(vector<big_number> &rooted, int last);
+big_number count_alkanes(vector<big_number> &rooted, int CarbonAmount);
+
+//big number function group
+big_number big_from(unsigned long long value);
+big_number big_add(big_number &first, big_number &second);
+big_number big_multiply(big_number &first, big_number &second);
+big_number big_multiply_small(big_number &number, unsigned int factor);
+big_number big_divide_small(big_number &number, unsigned int divisor, unsigned int &remainder);
+string big_to_string(big_number number);
+unsigned long long big_to_integer(big_number number);
+
+//index function group
+void morgan_index_init(morgan_index &index, int capacity);
+void morgan_index_grow(morgan_index &index);
+void morgan_index_add_statistics(morgan_index &total, morgan_index &part);
+unsigned long long morgan_hash(int CarbonAmount, int morgan[]);
 
 //ui function group
-bool print_intro();
-void print_structure(vector<vector<vector<int> > > &isomers);
-void print_Isomers(vector<vector<vector<int> > > &isomers, int CarbonAmount, string filenames[], vector<vector<int> > &morgans, bool generate_files);
+bool read_options(int argc, char *argv[], bool &count_only, bool &verify, bool &benchmark, string &resume_directory, int &generate_files, int &shard, int &shards, int &merge_shards);
+bool read_number(string text, int &number);
+void print_usage();
+bool print_intro(bool ask);
+void print_structure(isomer_level &first, int CarbonAmount);
+bool print_Isomers(vector<isomer_code> &current, int CarbonAmount, morgan_index &index, bool generate_files);
+bool print_cross_check(isomer_level &parents, vector<isomer_code> &current, int CarbonAmount);
+bool write_isomer_file(vector<isomer_code> &level, int CarbonAmount, string filename);
+string isomer_filename(string directory, int CarbonAmount);
 
 
 
@@ -65,48 +427,142 @@ void print_Isomers(vector<vector<vector<int> > > &isomers, int CarbonAmount, str
 // MAIN
 // ==============================================================================================================================================================================================================
 
-int main(){
-  int CarbonCount = lastCarbon - firstCarbon + 1;                                                                       //amount of alkanes generated in total
-  int arrayCount = CarbonCount + 2;                                                                                     //for usability, every vector uses vector[1...CarbonCount+2] with vector[0] reserved for
-                                                                                                                        //additional information (ie length of code, amount of isomers
+int main(int argc, char *argv[]){
+  isomer_level parents;                                                                                                 //isomers of the previous alkane, which the current alkane is generated from
+  vector<isomer_code> current;                                                                                          //packed codes of the current alkane's isomers, filled while they are found.
+                                                                                                                        //Only these two alkanes are kept: once an alkane is done, it becomes the previous
+                                                                                                                        //alkane and all earlier alkanes are released
+
+
+  bool count_only = false, verify = false, benchmark = false;                                                           //read the command line options
+  string resume_directory;
+  int chosen_output = -1;                                                                                               //1 or 0 if --output chose whether files are written, -1 otherwise
+  int shard = 0, shards = 0, merge_shards = 0;                                                                          //--shard and --merge-shards, 0 shards if not given
+  if(!read_options(argc, argv, count_only, verify, benchmark, resume_directory, chosen_output, shard, shards, merge_shards)) {
+    print_usage();
+    return 1;
+  }
+
+  if(shards>0) {                      //only one shard of alkane lastCarbon is generated from the isomer file of the previous alkane
+    return shard_Isomers(shard, shards);
+  }
+
+  if(merge_shards>0) {                //only the shard files of alkane lastCarbon are merged into its isomer file
+    return merge_Isomers(merge_shards);
+  }
+
+  if(benchmark) {                     //the alkanes are generated and timed, but neither printed as table nor written to files
+    return benchmark_Isomers();
+  }
 
-  vector<vector<vector<int> > > isomers(arrayCount, vector<vector<int> >(maxIsomers, vector<int>(arrayCount, -1)));     //main vector for isomer storage is initialized with a dimension of 22x500000x22,
-                                                                                                                        //where the first dimension is the carbon amount of current alkane, second dimension
-                                                                                                                        //represents the current isomer and the third dimension representing the digit of code
+  if(count_only) {                    //only the amounts of isomers are computed, nothing is generated
+    return count_Isomers(verify) ? 0 : 1;
+  }
 
+  if(engine==orderlyEngine) {         //the orderly engine only counts the isomers, so no files can be generated
+    if(chosen_output==1) {
+      cerr << "The orderly engine only counts the isomers, no isomer files are written." << endl;
+    }
+    orderly_Isomers();
+    return 0;
+  }
 
-  string filenames[21] = {"isomer/0.isomers",  "isomer/1.isomers",                                                      //string array to store the file names for output files
-                          "isomer/2.isomers",  "isomer/3.isomers", 
-                          "isomer/4.isomers",  "isomer/5.isomers", 
-                          "isomer/6.isomers",  "isomer/7.isomers",
-                          "isomer/8.isomers",  "isomer/9.isomers", 
-                          "isomer/10.isomers", "isomer/11.isomers",
-                          "isomer/12.isomers", "isomer/13.isomers",
-                          "isomer/14.isomers", "isomer/15.isomers",
-                          "isomer/16.isomers", "isomer/17.isomers", 
-                          "isomer/18.isomers", "isomer/19.isomers", 
-                          "isomer/20.isomers"};
+  bool generate_files=print_intro(chosen_output==-1 && isatty(0));                                                      //user introduction and, if run from a terminal without --output, input on
+  if(chosen_output!=-1) {                                                                                               //whether output files will be generated
+    generate_files = chosen_output;
+  }
 
+  vector<big_number> rooted;                                                                                            //the amounts of isomers are known in advance, so that the store can be sized
+  count_rooted_trees(rooted, lastCarbon);                                                                               //for the current alkane before it is generated
 
-  bool generate_files=print_intro();  //user introduction and input on whether output files will be generated
+  ofstream trace;                                                                                                       //if requested, the steps of every alkane are timed in the trace file
+  if(!traceFilename.empty()) {
+    trace.open(traceFilename.c_str());
+    if(!trace.is_open()) {
+      cerr << "Could not write " << traceFilename << "." << endl;
+      return 1;
+    }
+  }
 
 
 
 
  //METHANE DECLARATION
- isomers[1][1][1]=0;    //declare methane in isomer code  -> methane is [0]
- isomers[1][1][0]=0;
- isomers[1][0][0]=1;    //methane has 1 isomer
+ int startCarbon = 0;                      //alkane the generation starts from
+ string resume_filename;
+ if(!resume_directory.empty()) {           //if requested, start from the largest alkane saved in resume_directory instead
+   startCarbon = resume_level(resume_directory, lastCarbon, parents, resume_filename);
+   if(startCarbon==0) {
+     cout << "No complete isomer file found in " << resume_directory << ". Starting from methane." << endl;
+   } else {
+     cout << "Resuming from " << resume_filename << "." << endl;
+   }
+ }
+ if(startCarbon==0) {
+   current.push_back(0);                   //declare methane in isomer code  -> methane is [0], so methane has 1 isomer
+   level_from_codes(parents, current);
+   startCarbon = 1;
+ }
 
- print_structure(isomers);       //print table structure and methane
+ print_structure(parents, startCarbon);    //print table structure and methane (or the alkane resumed from)
+ if(generate_files && startCarbon>=firstCarbon && !write_isomer_file(parents.codes, startCarbon, isomer_filename(outputDirectory, startCarbon))) {
+   return 1;                                                                            //files that cannot be written end the run, see function finish_partial_file
+ }
+ if(descriptorSet!=0 && startCarbon>=firstCarbon && !write_descriptor_file(parents.codes, startCarbon, descriptor_filename(outputDirectory, startCarbon))) {
+   return 1;                                                                            //the first alkane is described here, all others while they are generated
+ }
+ bool write_checkpoints = checkpointLevels && !generate_files;                          //without output files, every finished alkane is saved as checkpoint to resume from
+ if(spillParents && startCarbon<lastCarbon && !save_level(parents, startCarbon, true, write_checkpoints)) {
+   return 1;                                                                            //the alkane started from is only spilled, it is already saved
+ }
 
 
 
  //MAIN ALKANE LOOP
- for(int CarbonAmount=2; CarbonAmount<=lastCarbon; CarbonAmount++){                    //for all amounts of carbon atoms between 2 and lastCarbon (including)
-   vector<vector<int> > morgans(maxIsomers+2, vector<int>(CarbonAmount+2, 0));         //initialize a vector for this alkane isomer's morgans codes
-   generate_Isomers(isomers, CarbonAmount, maxIsomers, morgans);                       //generate all possible isomers using the altered canonical representation
-   print_Isomers(isomers, CarbonAmount, filenames, morgans, generate_files);           //output all information
+ for(int CarbonAmount=startCarbon+1; CarbonAmount<=lastCarbon; CarbonAmount++){        //for all amounts of carbon atoms between startCarbon+1 and lastCarbon (including)
+   morgan_index index;                                                                 //initialize the statistics of the hash indexes over this alkane isomer's morgans codes
+   morgan_index_init(index, 1);
+   chrono::steady_clock::time_point level_start = chrono::steady_clock::now();
+   current.reserve(big_to_integer(count_alkanes(rooted, CarbonAmount)));               //room for exactly the amount of isomers that will be found
+   ofstream descriptors;                                                               //if requested, the descriptors of the isomers are written while they are generated
+   string descriptor_file = descriptor_filename(outputDirectory, CarbonAmount);
+   if(descriptorSet!=0 && CarbonAmount>=firstCarbon && !open_descriptor_file(descriptors, descriptor_file)) {
+     release_level(parents);
+     return 1;
+   }
+   generate_Isomers(parents, current, CarbonAmount, keyMode, index, descriptors.is_open() ? &descriptors : NULL);   //generate all possible isomers using the altered canonical representation
+   if(descriptors.is_open() && !close_descriptor_file(descriptors, descriptor_file)) {
+     release_level(parents);
+     return 1;
+   }
+   if(trace.is_open()) {
+     print_trace(trace, CarbonAmount, current.size(), index, seconds_since(level_start));
+   }
+   if(!print_Isomers(current, CarbonAmount, index, generate_files)) {                  //output all information
+     release_level(parents);
+     return 1;
+   }
+
+   if(crossCheckKeys && !print_cross_check(parents, current, CarbonAmount)) {          //if requested, compare the result with the other key mode and stop if they disagree
+     release_level(parents);
+     return 1;
+   }
+
+   release_level(parents);                                                             //the previous alkane is not needed anymore, the current alkane takes its place
+   level_from_codes(parents, current);
+   if(!save_level(parents, CarbonAmount, spillParents && CarbonAmount<lastCarbon, write_checkpoints)) {   //spill the finished alkane and save it as checkpoint, as requested
+     release_level(parents);
+     return 1;
+   }
+ }
+ release_level(parents);
+
+ if(trace.is_open()) {                                                                 //like all requested files, a trace that could not be written completely ends the run with an error
+   trace.close();
+   if(trace.fail()) {
+     cerr << "Could not write " << traceFilename << "." << endl;
+     return 1;
+   }
  }
 }
 
@@ -121,40 +577,252 @@ int main(){
 
 //generate_Isomers will use the previous alkane's isomer codes to generate all possible isomers of the current alkane by incrementing each digit once. This is equivalent to generating isomers by attaching a
 //carbon atom to an existing isomer structure to obtain an isomer of the next alkane.
-//The function loops over every isomer and every digit of the previous alkane and checks if the chosen digit can be incremented (see function Isomer_digit_validity_check) and does so if it is allowed.
-//It copies all digits up to the chosen digit to the current alkane isomer code, increments the current digit and adds a 0 behind it. Then the rest of the isomer code is copied and the whole isomer code
-//is passed to function check_isomer to examine the isomer's uniqueness. If it is unique, the amount of valid isomers (stored at isomers[CarbonAmount][0][0]) is incremented and a new isomer is generated.
-//Otherwise, the isomer will be dropped and the next isomer will be generated in its place.
+//The previous alkane's isomers are split into chunks of chunkParents isomers, which are extended by the worker threads independently of each other (see function generate_chunk). The chunks are handled
+//in waves of waveChunks chunks. Once all chunks of a wave are generated, every worker thread takes care of one shard of the Morgan's code hashes and marks each candidate of its shard that has not been
+//found in any earlier chunk (see function merge_shard). Finally, the marked candidates are appended to the current alkane's store chunk by chunk. As every chunk keeps its candidates in the order they
+//were generated in, the isomers end up in exactly the order a single thread would have found them in, no matter how many threads are used.
+//parents are the previous alkane's isomers, which are read from their spill file one wave at a time if they were spilled. current receives the current alkane's isomers. If room for the expected
+//amount of isomers was reserved in current beforehand, the shard indexes are created large enough to hold them without growing. mode selects the key used to judge uniqueness (see keyMode). The
+//counters of all indexes used are summed up in statistics, together with the time taken by each of the three steps of every wave.
+//If showProgress is set, the workers also add the work of every chunk to their counters in a level_progress, which report_progress reads on its own thread. Otherwise, nothing is counted during the
+//generation.
+//If descriptors is not NULL, the worker threads compute the descriptors of the unique candidates of every chunk once the chunks are merged (see function describe_isomer), and the rows are written to
+//descriptors together with the candidates, in the same order. Only the rows of one wave are kept at a time.
+
+void generate_Isomers(isomer_level &parents, vector<isomer_code> &current, int CarbonAmount, int mode, morgan_index &statistics, ofstream *descriptors){
+  current.clear();                                               //so far no valid isomers of new alkane were found
+
+  int workers = worker_count();
+  long long total_chunks = (parents.amount+chunkParents-1)/chunkParents;
+
+  vector<isomer_code> wave_buffer;                               //if the parents were spilled, each wave of them is unpacked from the mapped spill file into wave_buffer
+
+  vector<vector<int> > shard_morgans(workers);                   //each shard stores the Morgan's codes of its unique isomers found so far
+  vector<morgan_index> shard_indexes(workers);                   //and indexes them by their hash
+  int shard_capacity = 1024;                                     //an index grows once half of its slots are used
+  while((long long)shard_capacity < 2*(long long)current.capacity()/workers+2) {
+    shard_capacity *= 2;
+  }
+  for(int shard=0; shard<workers; shard++){
+    morgan_index_init(shard_indexes[shard], shard_capacity);
+  }
+
+  vector<isomer_chunk> chunks(waveChunks);
+  vector<chunk_keys> worker_keys(workers);                       //keys of the chunk each worker thread is generating
+
+  level_progress progress;                                       //if requested, the progress is reported while the alkane is generated
+  thread reporter;
+  if(showProgress) {
+    progress.carbons = CarbonAmount;
+    progress.parents = parents.amount;
+    progress.workers = vector<worker_progress>(workers);
+    progress.merge_duplicates = 0;
+    progress.stored = 0;
+    progress.used_slots = 0;
+    progress.slots = 0;
+    progress.done = false;
+    reporter = thread(report_progress, ref(progress));
+  }
 
-void generate_Isomers(vector<vector<vector<int> > > &isomers, int CarbonAmount, int maxIsomers, vector<vector<int> > &morgans){
-  int  previousC = CarbonAmount - 1;                             //previous alkane has previousC carbon atoms
-  int  previousIsomers = isomers[previousC][0][0];               //previous alkane has previousIsomers different isomers
-  int  isomer = 1;                                               //current alkane starts with isomer 1
-  isomers[CarbonAmount][0][0] = 0;                               //so far 0 valid isomers of new alkane were found
+  for(long long wave_start=0; wave_start<total_chunks; wave_start+=waveChunks){            //for every wave of chunks
+    chrono::steady_clock::time_point step_start = chrono::steady_clock::now();
+    int chunk_amount = min((long long)waveChunks, total_chunks-wave_start);
+    long long wave_first = wave_start*chunkParents;                                         //first parent of this wave
+    int wave_parents = min((long long)chunk_amount*chunkParents, parents.amount-wave_first);
+    const isomer_code *wave = NULL;
+    atomic<int> next_chunk(0);
+
+    if(!parents.spill_file.empty()) {                                                       //the parents of this wave are read from the spill file
+      wave_buffer.resize(wave_parents);
+      for(int parent=0; parent<wave_parents; parent++){
+        wave_buffer[parent] = isomer_file_code(parents.spill, wave_first+parent);
+      }
+      wave = &wave_buffer[0];
+    } else {
+      wave = &parents.codes[wave_first];
+    }
 
+    run_workers(workers, [&](int worker){                                                   //generate the candidates of every chunk in this wave, each thread taking the next free chunk
+      for(int chunk=next_chunk++; chunk<chunk_amount; chunk=next_chunk++){
+        int first = chunk*chunkParents;
+        int last  = min(wave_parents, first+chunkParents);
+        generate_chunk(wave, first, last, CarbonAmount, mode, chunks[chunk], worker_keys[worker]);
+
+        if(showProgress) {
+          worker_progress &counters = progress.workers[worker];
+          counters.parents += last-first;
+          counters.extensions += chunks[chunk].index.extensions;
+          counters.invalid += chunks[chunk].index.invalid;
+          counters.duplicates += chunks[chunk].index.duplicates;
+        }
+      }
+    });
+    statistics.generate_seconds += seconds_since(step_start);
+    step_start = chrono::steady_clock::now();
+
+    run_workers(workers, [&](int shard){                                                    //mark the candidates that have not been found before, each thread checking one shard
+      merge_shard(chunks, chunk_amount, shard, workers, CarbonAmount, shard_morgans[shard], shard_indexes[shard]);
+    });
+    statistics.merge_seconds += seconds_since(step_start);
+    step_start = chrono::steady_clock::now();
+
+    if(descriptors!=NULL) {                                                                 //if requested, describe the unique candidates of every chunk, each thread taking the next free chunk
+      next_chunk = 0;
+      run_workers(workers, [&](int){
+        alkane_graph graph;
+        for(int chunk=next_chunk++; chunk<chunk_amount; chunk=next_chunk++){
+          chunks[chunk].descriptors.clear();
+          for(int candidate=0; candidate<(int)chunks[chunk].codes.size(); candidate++){
+            if(chunks[chunk].unique[candidate]){
+              code_to_graph(chunks[chunk].codes[candidate], CarbonAmount, graph);
+              describe_isomer(graph, chunks[chunk].codes[candidate], chunks[chunk].descriptors);
+            }
+          }
+        }
+      });
+      statistics.describe_seconds += seconds_since(step_start);
+      step_start = chrono::steady_clock::now();
+    }
 
-  for(int I=1; I<=previousIsomers; I++){                                                    //for all isomers of previous alkane
+    for(int chunk=0; chunk<chunk_amount; chunk++){                                          //append the unique candidates in the order they were generated in
+      for(int candidate=0; candidate<(int)chunks[chunk].codes.size(); candidate++){
+        if(chunks[chunk].unique[candidate]){
+          current.push_back(chunks[chunk].codes[candidate]);
+        }
+      }
+      if(descriptors!=NULL) {
+        descriptors->write(chunks[chunk].descriptors.data(), chunks[chunk].descriptors.size());
+      }
+      morgan_index_add_statistics(statistics, chunks[chunk].index);
+    }
+    statistics.store_seconds += seconds_since(step_start);
+
+    if(showProgress) {
+      long long merge_duplicates = 0, used_slots = 0, slots = 0;
+      for(int shard=0; shard<workers; shard++){
+        merge_duplicates += shard_indexes[shard].duplicates;
+        used_slots += shard_indexes[shard].used;
+        slots += shard_indexes[shard].slots.size();
+      }
+      progress.merge_duplicates = merge_duplicates;
+      progress.stored = current.size();
+      progress.used_slots = used_slots;
+      progress.slots = slots;
+    }
+  }
 
-    for(int C=1; C<=previousC; C++){                                                        //for every carbon atom of this isomer
+  if(showProgress) {
+    {
+      lock_guard<mutex> guard(progress.lock);
+      progress.done = true;
+    }
+    progress.finished.notify_one();
+    reporter.join();
+  }
 
-      if(Isomer_digit_validity_check(isomers, previousC, C, I, CarbonAmount)){              //check validity of chosen isomer digit if incremented and if it is allowed:
+  for(int shard=0; shard<workers; shard++){
+    morgan_index_add_statistics(statistics, shard_indexes[shard]);
+    statistics.merge_duplicates += shard_indexes[shard].duplicates;
+  }
+}
 
-	for(int transfer=1; transfer<C; transfer++){                                        //transfer all characters up to C into new alkane isomer code 
-	  isomers[CarbonAmount][isomer][transfer] = isomers[previousC][I][transfer]; 
-        }
 
-	isomers[CarbonAmount][isomer][C] = isomers[previousC][I][C]+1;                      //increment chosen carbon by 1 and transfer new value to current alkane isomer
-	isomers[CarbonAmount][isomer][C+1]=0;                                               //add 0 after it (new branch is not connected any further)
 
-	for(int transfer=C+1; transfer<=CarbonAmount; transfer++){                          //transfer all digits after current C into new alkane isomer at C+1
-	  isomers[CarbonAmount][isomer][transfer+1] = isomers[previousC][I][transfer];
-	}
+//generate_chunk extends the parent isomers parents[first...last-1] at every digit allowed by Isomer_digit_validity_check. isomer_extend increments the chosen digit and inserts a 0 behind it, shifting the rest of
+//the packed code by one digit. The chunk is generated in two passes, which are timed separately:
+//  1. The key of every candidate is computed by isomer_key and collected in candidates, together with its code.
+//  2. The keys are looked up in the chunk's own index by check_morgan_uniqueness, so that only the first of several identical candidates of this chunk is kept in chunk.
+//The connectivity of every parent is determined once. As a candidate only differs from its parent by the new end group at digit C+1, its connectivity is derived from the parent's by graph_add_leaf
+//instead of reading the candidate's code again.
+//If Morgan's codes are used as keys and the processor supports it, the candidates are collected in batches of morganLanes and their keys are computed together by isomer_key_batch, in the same order as
+//isomer_key would. With Morgan's codes, the invariant of every candidate is derived from the parent's invariant as well (see function invariant_add_leaf). Canonical codes are never identical for
+//different isomers, so no invariant could tell them apart and none is computed (it is left at 0).
+
+void generate_chunk(const isomer_code parents[], int first, int last, int CarbonAmount, int mode, isomer_chunk &chunk, chunk_keys &candidates){
+  int previousC = CarbonAmount - 1;
+  int stride = CarbonAmount+1;
+
+  chunk.codes.clear();
+  chunk.morgans.clear();
+  chunk.hashes.clear();
+  morgan_index_init(chunk.index, 1024);
+  candidates.codes.clear();
+  candidates.keys.clear();
+  chrono::steady_clock::time_point pass_start = chrono::steady_clock::now();
+
+  alkane_graph parent_graph, candidate_graph;
+  morgan_batch batch;
+  bool batched = (mode==morganKeys && batchMorgans && morgans_batch_supported());
+  batch.amount = 0;
+  if(batched) {
+    morgans_network(CarbonAmount, batch.network);
+  }
 
-	if(check_Isomers(isomers, isomer, CarbonAmount, morgans)){                          //check new generated isomer for validity and uniqueness
-	  isomer++;                                                                         //if it is unique, the next isomer will be generated on the next position and the amount of valid codes is increased
-          isomers[CarbonAmount][0][0]++;                                                    //otherwise, current isomer will be overwritten with the next isomer
+  for(int I=first; I<last; I++){                                                            //key pass: for all isomers of previous alkane in this chunk
+    isomer_code parent = parents[I];
+    code_to_graph(parent, previousC, parent_graph);
+    unsigned long long parent_invariant = (mode==morganKeys) ? isomer_invariant(parent_graph) : 0;
 
+    for(int C=1; C<=previousC; C++){                                                        //for every carbon atom of this isomer
+      chunk.index.extensions++;
+
+      if(!Isomer_digit_validity_check(parent, C)){
+        chunk.index.invalid++;
+      } else {                                           //check validity of chosen isomer digit if incremented and if it is allowed:
+        isomer_code candidate = isomer_extend(parent, C);                                   //increment chosen carbon by 1 and add 0 after it
+
+        if(batched) {                                                                       //either collect the candidate for the next batch
+          graph_add_leaf(parent_graph, C, batch.graphs[batch.amount]);
+          batch.invariants[batch.amount] = invariant_add_leaf(parent_invariant, parent_graph, C);
+          batch.codes[batch.amount++] = candidate;
+          if(batch.amount==morganLanes) {
+            isomer_key_batch(batch, CarbonAmount, candidates);
+          }
+          continue;
         }
+
+        graph_add_leaf(parent_graph, C, candidate_graph);                                   //or attach the new end group to carbon C of the parent's connectivity
+
+        unsigned long long invariant = (mode==morganKeys) ? invariant_add_leaf(parent_invariant, parent_graph, C) : 0;
+
+        candidates.codes.push_back(candidate);                                              //and compute the key of the new generated isomer
+        candidates.keys.resize(candidates.keys.size()+stride);
+        isomer_key(candidate_graph, invariant, mode, &candidates.keys[candidates.keys.size()-stride]);
+      }
+    }
+  }
+  if(batch.amount>0) {                                                                      //compute the keys of the last, incomplete batch
+    isomer_key_batch(batch, CarbonAmount, candidates);
+  }
+  chunk.index.key_seconds = seconds_since(pass_start);
+  pass_start = chrono::steady_clock::now();
+
+  for(size_t candidate=0; candidate<candidates.codes.size(); candidate++){                  //lookup pass: check every candidate for uniqueness within this chunk
+    int *key = &candidates.keys[candidate*stride];
+    unsigned long long hash = morgan_hash(CarbonAmount, key);
+    if(check_morgan_uniqueness(key, hash, CarbonAmount, chunk.morgans, chunk.index)){       //if it is unique, keep it as a candidate for the current alkane, together with the hash for merge_shard
+      chunk.codes.push_back(candidates.codes[candidate]);
+      chunk.hashes.push_back(hash);
+    }
+  }
+  chunk.unique.assign(chunk.codes.size(), 0);
+  chunk.index.lookup_seconds = seconds_since(pass_start);
+}
+
+
+
+//merge_shard checks all candidates of the first chunk_amount chunks whose hash belongs to this shard against the keys of all isomers of this shard found so far. As the chunks are checked in order,
+//only the first candidate of each kind is marked as unique. Different shards never touch the same candidate, so all shards can be checked at the same time.
+
+void merge_shard(vector<isomer_chunk> &chunks, int chunk_amount, int shard, int shards, int CarbonAmount, vector<int> &morgans, morgan_index &index){
+  int stride = CarbonAmount+1;
+
+  for(int chunk=0; chunk<chunk_amount; chunk++){
+    for(int candidate=0; candidate<(int)chunks[chunk].codes.size(); candidate++){
+      unsigned long long hash = chunks[chunk].hashes[candidate];
+
+      if((int)((hash >> 40) % shards)==shard){                                              //the upper bits select the shard, as the lower bits select the slot in the index
+        chunks[chunk].unique[candidate] = check_morgan_uniqueness(&chunks[chunk].morgans[(size_t)candidate*stride], hash, CarbonAmount, morgans, index);
       }
     }
   }
@@ -167,12 +835,13 @@ void generate_Isomers(vector<vector<vector<int> > > &isomers, int CarbonAmount,
 //the root, as the root is always one of the atoms with the highest amount of bonds. This implementation simply checks for these conditions and thus prevents the entire generation and examination of an isomer
 //that violates these rules. This check is vital to limit the amount of isomers generated and reduce computation time based on simple conditions.
 
-int Isomer_digit_validity_check(vector<vector<vector<int> > > &isomers, int previousC, int C, int I, int CarbonAmount){
+int Isomer_digit_validity_check(isomer_code parent, int C){
+  int root = isomer_digit(parent, 1);
 
-  bool is_root_less_4 = (C==1 && isomers[previousC][I][1]<4);                                                                           //root cannot be greater than 4
-  bool not_root_less_3_less_root = (!(C==1) && isomers[previousC][I][C]<3 && ((isomers[previousC][I][C]+1)<isomers[previousC][I][1]));  //non-roots cannot be greater than root and 3
+  bool is_root_less_4 = (C==1 && root<4);                                                                                   //root cannot be greater than 4
+  bool not_root_less_3_less_root = (!(C==1) && isomer_digit(parent, C)<3 && ((isomer_digit(parent, C)+1)<root));            //non-roots cannot be greater than root and 3
 
-  if(is_root_less_4 || not_root_less_3_less_root){                                                                                      //if digit meets condition, return true, else false
+  if(is_root_less_4 || not_root_less_3_less_root){                                                                          //if digit meets condition, return true, else false
     return 1;
   } else {
     return 0;
@@ -181,247 +850,2399 @@ int Isomer_digit_validity_check(vector<vector<vector<int> > > &isomers, int prev
 
 
 
-//EXAMINATION FUNCTION GROUP
+//worker_count returns the amount of worker threads to use, which is threadCount or, if threadCount is 0, the amount of cores of the system
+
+int worker_count(){
+  if(threadCount>0) {
+    return threadCount;
+  }
+  return max(1, (int)thread::hardware_concurrency());
+}
 
-//check_isomer will return TRUE or FALSE depending on the uniqueness of the generated isomer. In order to judge the uniqueness, the canonical isomer code is translated into a sequence of morgans's algorithm
-//codes ordered by value which is compared to all existing morgan's codes. If no other isomer with this code exists, the isomer is unique and TRUE is returned.
-//The translation is done by morgans_splicing, the algorithm is executed by morgans_algorithm and the values are sorted by morgans_sort using insertion sort. The comparison to all generated isomers is
-//done by check_morgan_uniqueness.
 
-int check_Isomers(vector<vector<vector<int> > > &isomers, int isomer, int CarbonAmount,  vector<vector<int> > &morgans){
- 
-  vector<vector<int> > connections(CarbonAmount+2, vector<int>(CarbonAmount+2, 0));   //initialize a vector for this isomer code containing information on the connectivity between carbon atoms in this isomer
 
-  morgans_splicing(isomers, isomer, CarbonAmount, morgans, connections);              //split the isomer code into morgan's code and determine the connectivity between carbon atoms
-  morgans_algorithm(isomer, CarbonAmount, morgans, connections);                      //use the morgan's algorithm for CarbonAmount/2 iterations to generate canonical AND comparable isomer code
-  morgans_sort(isomer, CarbonAmount, morgans);                                        //sort the values of the morgan's code by value, to make the comparison easier
+//run_workers calls work(0...workers-1), each call on its own thread, and returns once all calls have finished. The calling thread takes care of work(0) itself.
 
+void run_workers(int workers, const function<void(int)> &work){
+  vector<thread> threads;
 
-  return check_morgan_uniqueness(isomer, CarbonAmount, morgans);                      //check if the generated morgan's code is unique and thus represents a valid new isomer
+  for(int worker=1; worker<workers; worker++){
+    threads.push_back(thread(work, worker));
+  }
+  work(0);
+  for(int worker=0; worker<(int)threads.size(); worker++){
+    threads[worker].join();
+  }
 }
 
 
 
-//morgans_splicing is responsible to create the connectivity table based on the canonical isomer representation of generate_isomers. In addition, it copies the initial values for the Morgan's values
-//into the morgans vector.
-//The canonical representation of generate_isomers contains connectivity information. However, to facilitate easy generation of isomers, the representation has to be analyzed to obtain the information.
-//This is done by a simple concept: Each branch of the isomer ends with a 0. Every atom with a 1 has a connection to the next atom in the code, and the previous one. For >1, the idea of "foreign connections" 
-//is used. If for example the code [...2100...] represents a split branch with a methyl and ethyl-subsituent, the carbon atom represented by 2 is connected to the 1 and the second 0, as the first 0 is only
-//connected to the 1 and belongs to the end of the ethyl-substituent. So, the first 0 is a "foreign connection", an atom that is not connected to the carbon atom we are looking at, but is found in the code
-//before the second (or third, ...) connection. So while there are still foreign connections unfilled, the atom we are looking at does not have a connection to the current atom. This is true for all values
-//>1.
-//This implementation first creates the initial Morgan's code by incrementing all values by 1 but the root, and copying it into the morgans vector. This code is later used for Morgan's Algorithm.
-//Then, the amount of connections of the current atom is determined as its value in the canonical representation. If it has at least one connection, it is connected to the next atom in the code.
-//While there are still connections open, the algorithm will add the value of the current atom as the amount of foreign connections (ie. a value of 1 means 1 additional foreign connection, see example).
-//If there are no foreign connections open, the current atom is connected to the one we are examining. This means, that for both atoms, the connectivity to the other atom is saved in the connections table.
-//In addition, the amount of connections of each atom in this bond saved at connection[digit][0] is incremented.
-//If there are foreign connections open, the current atom's value is added to the amount of foreign connections and the amount of foreign connections is decreased by 1.
-//In the end, the connections vector contains the amount of bonds of each atom at n=connections[digit][0] and the atoms it is connected to at connections[digit][1..n].
-//As the algorithm only checks for forward connectivity, only connections to atoms that appear later in the code are recognized. This is why the canonical representation of generate_isomers is important, as
-//it decreases each digit but the root by 1 and thus accounts for the backward connectivity of each atom (the root is not backwards connected at it is the first digit in the representation).
-//Because both atoms recieve the connection information if a forward bond is found, the backwards connection is still present in the connections table for the other atom. 
+//LEVEL FUNCTION GROUP
 
-void morgans_splicing(vector<vector<vector<int> > > &isomers, int isomer, int CarbonAmount, vector<vector<int> > &morgans, vector<vector<int> > &connections) {
+//level_from_codes turns the codes into an isomer_level kept in memory. The codes are moved into the level, leaving codes empty.
 
-  for(int main_digit=1; main_digit<=CarbonAmount; main_digit++) {                           //cycle through all digits of the current canonical isomer code
+void level_from_codes(isomer_level &level, vector<isomer_code> &codes){
+  level.codes.clear();
+  level.codes.swap(codes);
+  level.amount = level.codes.size();
+  level.spill_file = "";
+  level.keep_spill_file = false;
+}
 
-    int connections_n=isomers[CarbonAmount][isomer][main_digit], foreign_connections_n=0;   //the amount of (forward) connections is the same as the value in the isomer code
 
-    if(main_digit==1) {                                                                     //TRANSLATION INTO MORGAN'S CODE OF 0th ITERATION
-      morgans[isomer][main_digit]=isomers[CarbonAmount][isomer][main_digit];                //If digit is root, copy same value into morgans vector
-    } else {
-      morgans[isomer][main_digit]=isomers[CarbonAmount][isomer][main_digit]+1;              //if digit is not root, copy the value+1 into the morgans vector, as there is a backwards bond
+
+//spill_level writes all codes of level to the binary isomer file filename and releases their memory. Afterwards, generate_Isomers reads them back from filename one wave at a time. CarbonAmount is the
+//amount of carbon atoms of the level's alkane. If keep is set, filename is the checkpoint file, which stays in place once the level is released. The file is mapped into memory right away, so that
+//generate_Isomers can rely on it. If the file could not be written or mapped, the codes are kept in memory and FALSE is returned.
+
+bool spill_level(isomer_level &level, int CarbonAmount, string filename, bool keep){
+  if(!write_binary_isomer_file(&level.codes[0], level.amount, CarbonAmount, filename)) {
+    return false;
+  }
+  if(!open_isomer_file(filename, level.spill) || level.spill.amount!=level.amount) {
+    close_isomer_file(level.spill);
+    if(!keep) {
+      remove(filename.c_str());
     }
+    cerr << "Could not read back " << filename << "." << endl;
+    return false;
+  }
+
+  vector<isomer_code>().swap(level.codes);
+  level.spill_file = filename;
+  level.keep_spill_file = keep;
+  return true;
+}
 
-    if(!(connections_n==0)) {                                                               //if there is at least one forward connection (code=[1,2,3,4])
-      connections[main_digit][0]++;                                                         //active atom has one additional connection in connections table
-      connections[main_digit][connections[main_digit][0]]=main_digit+1;                     //this connections is to the next atom in the code
-      connections[main_digit+1][0]++;                                                       //the next atom in the code has a backwards connection to the active atom, so increment connections amount
-      connections[main_digit+1][connections[main_digit+1][0]]=main_digit;                   //the connection is to the current atom
-      connections_n--;                                                                      //one connection was found, decrease remaining connections by 1
-      foreign_connections_n+=isomers[CarbonAmount][isomer][main_digit+1];                   //the value of the next atom represents the amount of foreign connections 
+
+
+//save_level saves the finished level of CarbonAmount carbon atoms as checkpoint if checkpoint is set, and spills it if spill is set. The checkpoint doubles as spill file, so that each alkane is
+//written only once. As the checkpoint is not requested by the user, a checkpoint that cannot be written only ends the checkpoints: a warning is printed once, checkpoint is cleared and the level is
+//spilled to spillFilename instead. FALSE is only returned if the level could not be spilled.
+
+bool save_level(isomer_level &level, int CarbonAmount, bool spill, bool &checkpoint){
+  string checkpoint_file = outputDirectory+"/"+checkpointFilename;
+  if(checkpoint) {
+    bool saved = spill ? spill_level(level, CarbonAmount, checkpoint_file, true) : write_binary_isomer_file(&level.codes[0], level.amount, CarbonAmount, checkpoint_file);
+    if(saved) {
+      return true;
     }
+    cerr << "No further checkpoints are saved, the run continues without them." << endl;
+    checkpoint = false;
+  }
+  if(spill) {
+    return spill_level(level, CarbonAmount, outputDirectory+"/"+spillFilename, false);
+  }
+  return true;
+}
+
+
+
+//release_level releases the memory of level and removes its spill file, if there is one and it is not the checkpoint
+
+void release_level(isomer_level &level){
+  vector<isomer_code>().swap(level.codes);
+  close_isomer_file(level.spill);
+  if(!level.spill_file.empty() && !level.keep_spill_file) {
+    remove(level.spill_file.c_str());
+  }
+  level.spill_file = "";
+  level.keep_spill_file = false;
+  level.amount = 0;
+}
+
+
+
+//resume_level loads the largest alkane of at most last carbon atoms that has a complete isomer file in directory into level and returns its amount of carbon atoms, or 0 if there is none. Both
+//the files [carbon atoms].isomers written by print_Isomers and the checkpoint file written instead of them are considered (see function read_isomer_file). A file is only accepted if its amount of
+//isomers is the one count_alkanes computes for its alkane, so that a file which is incomplete or belongs to a different program version is not resumed from. filename receives the file loaded.
+
+int resume_level(string directory, int last, isomer_level &level, string &filename){
+  vector<big_number> rooted;
+  count_rooted_trees(rooted, last);
 
-    for(int digit=main_digit+2; digit<=CarbonAmount && connections_n>0; digit++) {          //for every digit in the code following active atom+2 and while not all connections have been found:
+  string candidates[2] = {directory+"/"+checkpointFilename, ""};
+  int best = 0;
+  vector<isomer_code> codes;
 
-      if(foreign_connections_n==0) {                                                        //if there are no open foreign connections, the digit atom is connected to the main_digit atom
-	connections[main_digit][0]++;                                                       //increment both the connections amount of the active_digit and digit
-	connections[main_digit][connections[main_digit][0]]=digit;                          //and insert the connection to the other atom in the connections table
-        connections[digit][0]++;
-        connections[digit][connections[digit][0]]=main_digit;
-        connections_n--;                                                                    //one additional connection was found, decrease remanining connections by 1
-        foreign_connections_n+=isomers[CarbonAmount][isomer][digit];                        //the amount of foreign connections is the amount of forwards connections of digit atom 
- 
-      } else {                                                                              //if there are foreign connections open:
-        foreign_connections_n+=isomers[CarbonAmount][isomer][digit];                        //the amount of remaining foreign connections is increased by the value of digit atom
-	foreign_connections_n--;                                                            //as one foreign connection was found and ignored, decrement the amount of foreign connections
+  for(int CarbonAmount=last; CarbonAmount>=1; CarbonAmount--){                        //try the checkpoint first and then the alkanes from the largest to the smallest
+    candidates[1] = isomer_filename(directory, CarbonAmount);
+    for(int candidate=0; candidate<2; candidate++){
+      if(candidate==0 && CarbonAmount<last) {
+        continue;
       }
-    } 
+      int carbons = read_isomer_file(candidates[candidate], (candidate==0) ? 0 : CarbonAmount, codes);
+      if(carbons>best && carbons<=last && big_from(codes.size()).limbs==count_alkanes(rooted, carbons).limbs) {
+        best = carbons;
+        filename = candidates[candidate];
+        level_from_codes(level, codes);
+      }
+    }
+    if(best>=CarbonAmount) {
+      break;
+    }
   }
+  return best;
 }
 
 
 
-//morgans_algorithm will use Morgan's Algorithm to generate a canonical value for each of the isomer's carbon atoms that contains information of the isomers complete structure. Instead of terminating when no 
-//change in the amount of different values is found, as Morgan's Algorithm suggests, the algorithm will be applied a total of (CarbonAtom/2)+1 times. This way, the generated values can be used without 
-//translation into a ranking. With (CarbonAtom/3)+1 iterations, every value has information of the connectivity of at least 50% of the entire structure, which is more than enough to ensure that the maximum 
-//diversity for the Morgan's values has been found.
-//This implementation cycles a total of (CarbonAmount/3)+1 times. Each time, the previous representation is copied to a temporary array and each carbon atom is assigned the sum of the values of each carbon
-//atom it is connected to. This is done using the connectivity table generated by morgans_splicing. The new value is stored in the morgans vector.
+//ISOMER FILE FUNCTION GROUP
 
-void morgans_algorithm(int isomer, int CarbonAmount, vector<vector<int> > &morgans, vector<vector<int> > &connections){
+//code_width returns the amount of bits a packed isomer code of the alkane with CarbonAmount carbon atoms takes: 3 bits for the root and 2 bits for every other digit
 
-  int iteration=0;                                                                              //initialize the iteration counter as 0
-  int temp[CarbonAmount+1];                                                                     //initialize the temporary array to store previous values
+int code_width(int CarbonAmount){
+  return 3+2*(CarbonAmount-1);
+}
 
-  while(iteration<=(CarbonAmount/3)){                                                           //while there were less than (CarbonAmount/2)+1 iterations
 
-    for(int digit=1; digit<=CarbonAmount; digit++){                                             //copy all previous values to temporary array
-      temp[digit]=morgans[isomer][digit];
-    }
 
-    for(int digit=1; digit<=CarbonAmount; digit++){                                             //for every carbon atom:
-      int connections_n=connections[digit][0];                                                  //check the amount of connections it has
-      morgans[isomer][digit]=0;                                                                 //reset the current carbon atoms Morgan's value to 0
+//write_binary_isomer_file writes the first amount codes of codes[] as binary isomer file (see struct isomer_file) to filename. The whole file is assembled in memory and written in a single write.
+//8 bytes of padding at the end allow isomer_file_code to always read whole words. The file is written under a temporary name and renamed once it is complete, so that an interrupted run never
+//leaves a partial file named filename behind. FALSE is returned, and an error is printed, if the file could not be written (see function finish_partial_file).
 
-      for(int current_connection=1; current_connection<=connections_n; current_connection++){   //for every connection this carbon atom has
-	morgans[isomer][digit]+=temp[connections[digit][current_connection]];                   //add the value of the connected carbon atom to the current atoms Morgan's value
-      }
+bool write_binary_isomer_file(const isomer_code codes[], long long amount, int CarbonAmount, string filename){
+  int width = code_width(CarbonAmount);
+  size_t payload = (amount*width+7)/8;
+  vector<unsigned char> buffer(32+payload+8, 0);
+
+  memcpy(&buffer[0], "ALKANISO", 8);                                                   //header
+  unsigned long long fields[4] = {1, (unsigned long long)CarbonAmount, (unsigned long long)amount, (unsigned long long)width};
+  int offsets[4] = {8, 12, 16, 24};
+  int sizes[4]   = {4, 4, 8, 4};
+  for(int field=0; field<4; field++){
+    for(int byte=0; byte<sizes[field]; byte++){
+      buffer[offsets[field]+byte] = (fields[field] >> (8*byte)) & 0xFF;
+    }
+  }
+
+  unsigned char *data = &buffer[32];                                                   //packed codes, lowest bit first
+  for(long long isomer=0; isomer<amount; isomer++){
+    unsigned long long bit = isomer*width;
+    isomer_code code = codes[isomer];
+    for(int written=0; written<width; ){                                               //write the code byte by byte, starting in the middle of a byte if necessary
+      int shift = (bit+written) & 7;
+      data[(bit+written)>>3] |= (code >> written) << shift;
+      written += 8-shift;
     }
-    iteration++;                                                                                //increment the amount of iterations done
   }
+
+  string partial = filename+".partial";                                                //the file only appears under its name once it is complete
+  ofstream file(partial.c_str(), ios::binary);
+  file.write((const char*)&buffer[0], buffer.size());
+  return finish_partial_file(file, partial, filename);
 }
 
 
 
-//morgans_sort uses insertion sort to reorder the values stored for the current isomers morgan's code in the morgans vector. morgans[isomer][0] acts as sentinel. After this function is called, the code at
-//morgans[isomer][1...CarbonAmount+1] is sorted by value, beginning with the highest value
+//finish_partial_file closes file, which was written under the temporary name partial, and renames it to filename. If the file could not be opened, written or closed, or if it cannot be renamed, the
+//temporary file is removed, an error is printed on stderr and FALSE is returned, so that a missing output directory or a full disk never go unnoticed.
 
-void morgans_sort(int isomer, int CarbonAmount, vector<vector<int> > &morgans){
+bool finish_partial_file(ofstream &file, string partial, string filename){
+  file.close();
+  if(!file || rename(partial.c_str(), filename.c_str())!=0) {
+    remove(partial.c_str());
+    cerr << "Could not write " << filename << "." << endl;
+    return false;
+  }
+  return true;
+}
 
-  int main, compare;                                               //two positions on the code are initialized, the digit that moves, main, and the digits that main is compared to, compare
 
-  for(main=2; main<=CarbonAmount; main++) {                        //cycle through every digit of the code, beginning at 2 (first digit is "sorted" as it is the only digit up to current main)
-    morgans[isomer][0]=morgans[isomer][main];                      //copy current value to position 0 to act as sentinel
-    compare=main;                                                  //initialize compare digit to be at the current main's position
 
-    while(morgans[isomer][0]>morgans[isomer][compare-1]){          //while the values in front of main are less than the main's value
-      morgans[isomer][compare]=morgans[isomer][compare-1];         //transfer the value in front to current position
-      compare--;                                                   //check for the next (previous) digit
+//open_isomer_file maps the binary isomer file filename into memory and reads its header. It returns FALSE if the file cannot be opened or is no complete binary isomer file, i.e. if the header is
+//missing or wrong, or if the file is too short to hold the amount of codes given in the header.
+
+bool open_isomer_file(string filename, isomer_file &file){
+  file.descriptor = open(filename.c_str(), O_RDONLY);
+  file.data = NULL;
+  if(file.descriptor==-1) {
+    return false;
+  }
+
+  struct stat status;
+  fstat(file.descriptor, &status);
+  file.size = status.st_size;
+  if(file.size<32) {
+    close_isomer_file(file);
+    return false;
+  }
+
+  void *mapping = mmap(NULL, file.size, PROT_READ, MAP_SHARED, file.descriptor, 0);
+  if(mapping==MAP_FAILED) {
+    close_isomer_file(file);
+    return false;
+  }
+  file.data = (const unsigned char*)mapping;
+
+  unsigned long long fields[4] = {0, 0, 0, 0};                                         //read the header
+  int offsets[4] = {8, 12, 16, 24};
+  int sizes[4]   = {4, 4, 8, 4};
+  for(int field=0; field<4; field++){
+    for(int byte=0; byte<sizes[field]; byte++){
+      fields[field] |= (unsigned long long)file.data[offsets[field]+byte] << (8*byte);
     }
-    morgans[isomer][compare]=morgans[isomer][0];                   //if the previous digit is greater, insert digit at current position
   }
+  file.carbons = fields[1];
+  file.amount  = fields[2];
+  file.width   = fields[3];
+
+  bool valid = memcmp(file.data, "ALKANISO", 8)==0 && fields[0]==1 &&                  //check the header and that the file is long enough for all codes and the padding
+               file.carbons>=1 && file.carbons<=maxCodeCarbons && file.width==code_width(file.carbons) &&
+               file.amount>=0 && file.size >= (size_t)(32+(file.amount*file.width+7)/8+8);
+  if(!valid) {
+    close_isomer_file(file);
+  }
+  return valid;
+}
+
+
+
+//isomer_file_code returns the packed code of isomer number isomer (starting at 0) of a mapped binary isomer file. The 8 bytes containing the start of the code are copied into a word, which relies on the
+//lowest byte first order of x86 and ARM processors. As a code takes at most 63 bits, it spans at most one more byte.
+
+isomer_code isomer_file_code(isomer_file &file, long long isomer){
+  unsigned long long bit = isomer*file.width;
+  const unsigned char *start = file.data+32+(bit>>3);
+  int shift = bit & 7;
+
+  unsigned long long word;
+  memcpy(&word, start, 8);
+  isomer_code code = word >> shift;
+  if(shift+file.width>64) {
+    code |= (unsigned long long)start[8] << (64-shift);
+  }
+  return code & ((1ULL << file.width)-1);
 }
 
 
 
-//check_morgan_uniqueness will go through the list of all Morgan's codes of the current alkane to search for an identical code. The implementation uses the Morgan's code it is checking for as a sentinel
-//at the end of the morgans vector to ensure termination. The implementation stops at the first occurence of the code.
+//close_isomer_file unmaps and closes an isomer file opened by open_isomer_file. Closing a file that is not open does nothing.
+
+void close_isomer_file(isomer_file &file){
+  if(file.data!=NULL) {
+    munmap((void*)file.data, file.size);
+    file.data = NULL;
+  }
+  if(file.descriptor!=-1) {
+    close(file.descriptor);
+    file.descriptor = -1;
+  }
+}
+
+
 
-int check_morgan_uniqueness(int isomer, int CarbonAmount, vector<vector<int> > &morgans){
-  int twin_found=0;                                                                                           //twin_found is the exit condition for the while loop, it is triggered if the same isomer is found
-  int current_isomer=0;                                                                                       //current_isomer keeps track of the isomer that is compared to
+//read_isomer_file reads all isomer codes of the isomer file filename into codes and returns the amount of carbon atoms of its alkane. Binary files are recognized by their header (see struct
+//isomer_file), all other files are read as text files as written by write_isomer_file. If CarbonAmount is not 0, the file has to belong to the alkane with CarbonAmount carbon atoms. 0 is returned if
+//the file cannot be read or is not complete, i.e. if the header is missing, if the amount of codes is not the one given in the header or if a code does not have the width of the alkane's codes.
+//A text code is also rejected if its digits do not describe a tree of CarbonAmount atoms, which have to add up to CarbonAmount-1 bonds.
 
-  while(!twin_found){                                                                                         //as long as there is no identical isomer already in the vector found, keep searching
-    int current_digit=1;                                                                                      //current_digit keeps track of the digit in the current isomer that is compared to
-    current_isomer++;                                                                                         //if previous isomer was not identical, the next one will be checked
+int read_isomer_file(string filename, int CarbonAmount, vector<isomer_code> &codes){
+  codes.clear();
 
-    while((current_digit <= CarbonAmount) &&                                                                  //check if digit in both isomers are identical and the isomer end has not been reached
-          (morgans[isomer][current_digit]==morgans[current_isomer][current_digit])){                          //(shortcut property of && used to prevent possible segmentation faults)
-      current_digit++;                                                                                        //if the digits are identical, check for the next digit
+  isomer_file binary;
+  if(open_isomer_file(filename, binary)) {                                            //binary file: the header has already been checked against the file length
+    int carbons = binary.carbons;
+    if(CarbonAmount==0 || carbons==CarbonAmount) {
+      codes.resize(binary.amount);
+      for(long long isomer=0; isomer<binary.amount; isomer++){
+        codes[isomer] = isomer_file_code(binary, isomer);
+      }
+    } else {
+      carbons = 0;
     }
+    close_isomer_file(binary);
+    return carbons;
+  }
+
+  ifstream file(filename.c_str());                                                    //text file: header lines, followed by one code per line
+  string carbon_caption = "# Carbon atoms in this alkane: ";
+  string amount_caption = "# Amount of isomers found for this alkane: ";
+  string line;
+  if(!getline(file, line) || line.compare(0, carbon_caption.size(), carbon_caption)!=0) {
+    return 0;
+  }
+  int carbons = atoi(line.c_str()+carbon_caption.size());
+  if(!getline(file, line) || line.compare(0, amount_caption.size(), amount_caption)!=0) {
+    return 0;
+  }
+  long long amount = atoll(line.c_str()+amount_caption.size());
+  if(carbons<1 || carbons>maxCodeCarbons || (CarbonAmount!=0 && carbons!=CarbonAmount)) {
+    return 0;
+  }
 
-    if(current_digit>CarbonAmount){                                                                           //if the while loop reaches the end the isomer code, the isomers are identical
-      twin_found=1;                                                                                           //exit condition is set to true, escaping the loop over every isomer
-    }                                                                                                         //because there is a sentinel at the end of the vector, the wile loop always terminates
+  int digits[maxCodeCarbons+2];
+  while(getline(file, line)) {
+    if((int)line.size()!=carbons) {
+      return 0;
+    }
+    int bonds = 0;
+    for(int digit=1; digit<=carbons; digit++){
+      digits[digit] = line[digit-1]-'0';
+      if(digits[digit]<0 || digits[digit]>((digit==1) ? 4 : 3)) {
+        return 0;
+      }
+      bonds += digits[digit];
+    }
+    if(bonds!=carbons-1) {
+      return 0;
+    }
+    codes.push_back(isomer_pack(digits, carbons));
   }
 
-  if(current_isomer==isomer){                                                                                 //check position of the identical code found in the vector
-    return 1;                                                                                                 //if the only identical isomer found is the sentinel, the isomer itself, the isomer is unique
-  } else {                                                                                                    //otherwise an identical isomer has already been generated and this one is to be ignored
+  if((long long)codes.size()!=amount) {
     return 0;
   }
+  return carbons;
 }
 
 
 
-//UI FUNCTION GROUP
+//CODE FUNCTION GROUP
 
-//print_intro will print the introduction and ask whether output files should be generated
+//digit_shift returns the position of the lowest bit of a digit in a packed isomer_code. The root occupies bits 0-2, every following digit 2 bits.
 
-bool print_intro(){
-  char answer;
-  bool boolean;
+int digit_shift(int digit){
+  if(digit==1) {
+    return 0;
+  }
+  return 3+2*(digit-2);
+}
 
-  cout << endl;
-  cout << "Generation and enumeration of all alkane constitutional isomers up to icosane   " << endl;
-  cout << "================================================================================" << endl;
-  cout << "by Andreas Gimpel, agimpel@student.ethz.ch                                      " << endl;
-  cout << "an entry to Prof. Philippe H. Hünenberger's challenge HS15                      " << endl;
-  cout << endl;
-  cout << "This program will enumerate the constitutional isomers from methane to icosane  " << endl;
-  cout << "using a canonical representation of isomers and a modified Morgan's algorithm.  " << endl;
-  cout << "Depending on the system, computation time may exceed 1h. Termination is possible" << endl;
-  cout << "with CTRL-C. Documentation available in the attached .pdf file and the code.    " << endl;
-  cout << endl;
-  cout << "Should all valid isomer codes be output to files to allow for reconstruction    " << endl;
-  cout << "(This will require the directory '/isomer' to be present)?  [y/n]               " << endl;  
-  cin  >> answer;
 
-  if(answer=='y') {
-    boolean=1;
-    cout << "Output will be generated in /isomer as [Carbon Atoms in alkane].isomers. " << endl;
-  } else if(answer=='n') {
-    boolean=0;
-    cout << "No output files will be generated." << endl;
+
+//isomer_digit extracts a single digit from a packed isomer_code
+
+int isomer_digit(isomer_code code, int digit){
+  if(digit==1) {
+    return code & 7;
+  }
+  return (code >> digit_shift(digit)) & 3;
+}
+
+
+
+//isomer_extend creates the code of the isomer obtained by attaching a new carbon atom to carbon C of the parent. All digits behind C are moved one digit up, which opens an empty (0) 2 bit field for the
+//new atom at digit C+1, and digit C is incremented by 1.
+
+isomer_code isomer_extend(isomer_code parent, int C){
+  int shift = digit_shift(C+1);
+  isomer_code low  = parent & ((1ULL << shift) - 1);                //digits 1...C stay in place
+  isomer_code high = (parent >> shift) << (shift+2);                //digits C+1... are moved behind the new digit C+1
+
+  return (low | high) + (1ULL << digit_shift(C));                   //increment digit C
+}
+
+
+
+//isomer_unpack copies the digits of a packed isomer_code into digits[1...CarbonAmount], so the code can be scanned as a contiguous array. digits[CarbonAmount+1] is set to 0.
+
+void isomer_unpack(isomer_code code, int CarbonAmount, int digits[]){
+  digits[1] = code & 7;
+  code >>= 3;
+  for(int digit=2; digit<=CarbonAmount; digit++){
+    digits[digit] = code & 3;
+    code >>= 2;
+  }
+  digits[CarbonAmount+1] = 0;
+}
+
+
+
+//isomer_pack packs the digits digits[1...CarbonAmount] into an isomer_code, undoing isomer_unpack
+
+isomer_code isomer_pack(int digits[], int CarbonAmount){
+  isomer_code code = 0;
+  for(int digit=CarbonAmount; digit>=2; digit--){
+    code = (code << 2) | digits[digit];
+  }
+  return (code << 3) | digits[1];
+}
+
+
+
+//EXAMINATION FUNCTION GROUP
+
+//isomer_key translates the connectivity of an isomer into the key its uniqueness is judged by and writes it to morgan[0...CarbonAmount]. The key is either a sequence of morgans's algorithm codes
+//ordered by value (mode morganKeys, see function morgans_code) or the exact canonical code of the isomer's tree (mode canonicalKeys, see function canonical_code). It is preceded by the isomer's
+//invariant (see function isomer_invariant) at morgan[0], which check_morgan_uniqueness compares before the full keys. This guards the heuristic Morgan's codes against identical codes of different
+//isomers; with canonical keys, invariant is 0.
+
+void isomer_key(alkane_graph &graph, unsigned long long invariant, int mode, int morgan[]){
+  if(mode==canonicalKeys) {
+    canonical_code(graph, morgan);                                                    //translate the connectivity into its canonical code
   } else {
-    cout << "No valid input. Defaulting to no output." << endl;
-    boolean=0;
+    morgans_code(graph, morgan);                                                      //translate the connectivity into its sorted morgan's code, morgan[0] is used as sentinel
   }
-  return boolean;
+  morgan[0] = invariant ^ (invariant >> 32);                                          //the invariant is folded into the 32 bits of morgan[0]
 }
 
 
 
-//print_structure simply prints table captions and the predefined isomer code for methane
+//morgans_code translates the connectivity of an isomer into its sorted morgan's code at morgan[1...CarbonAmount].
+//The initial Morgan's value of every carbon atom is its amount of bonds, the algorithm is executed by morgans_algorithm and the values are sorted by morgans_sort using insertion sort.
 
-void print_structure(vector<vector<vector<int> > > &isomers){
-  cout << endl;
-  cout << "n \t" << "#isomers" << endl;
-  cout << "____________________________________" << endl;
-  cout << "1 \t" << isomers[1][0][0] << endl;
+void morgans_code(alkane_graph &graph, int morgan[]){
+
+  for(int digit=1; digit<=graph.atoms; digit++){                                      //the Morgan's code of the 0th iteration is the amount of bonds of every atom
+    morgan[digit]=graph.degree[digit];
+  }
+
+  morgans_algorithm(graph, morgan);                                                   //use the morgan's algorithm for CarbonAmount/2 iterations to generate canonical AND comparable isomer code
+  morgans_sort(graph.atoms, morgan);                                                  //sort the values of the morgan's code by value, to make the comparison easier
 }
 
 
 
-//print_Isomers will ouput the amount of isomers found after each main alkane cycle as well as create the output file, if it was enabled
+//morgans_algorithm will use Morgan's Algorithm to generate a canonical value for each of the isomer's carbon atoms that contains information of the isomers complete structure. Instead of terminating when no 
+//change in the amount of different values is found, as Morgan's Algorithm suggests, the algorithm will be applied a total of (CarbonAtom/2)+1 times. This way, the generated values can be used without 
+//translation into a ranking. With (CarbonAtom/3)+1 iterations, every value has information of the connectivity of at least 50% of the entire structure, which is more than enough to ensure that the maximum 
+//diversity for the Morgan's values has been found.
+//This implementation cycles a total of (CarbonAmount/3)+1 times. Each time, the previous representation is copied to a temporary array and each carbon atom is assigned the sum of the values of each carbon
+//atom it is connected to. The atoms each atom is connected to are taken from the isomer's connectivity graph. The new value is stored in the morgans vector.
+
+void morgans_algorithm(alkane_graph &graph, int morgan[]){
+
+  int CarbonAmount=graph.atoms;
+  int iteration=0;                                                                              //initialize the iteration counter as 0
+  int temp[maxCodeCarbons+2];                                                                   //initialize the temporary array to store previous values
+
+  while(iteration<=(CarbonAmount/3)){                                                           //while there were less than (CarbonAmount/2)+1 iterations
 
-void print_Isomers(vector<vector<vector<int> > > &isomers, int CarbonAmount, string filenames[], vector<vector<int> > &morgans, bool generate_files){
+    for(int digit=1; digit<=CarbonAmount; digit++){                                             //copy all previous values to temporary array
+      temp[digit]=morgan[digit];
+    }
 
-  cout << CarbonAmount << " \t" << isomers[CarbonAmount][0][0] << endl;
+    for(int digit=1; digit<=CarbonAmount; digit++){                                             //for every carbon atom:
+      int connections_n=graph.degree[digit];                                                    //check the amount of connections it has
+      morgan[digit]=0;                                                                          //reset the current carbon atoms Morgan's value to 0
 
-  if(isomers[1][1][0]==0 && generate_files) {
-    ofstream file(filenames[1].c_str());
-    file << "# Carbon atoms in this alkane: " << 1 << endl << "# Amount of isomers found for this alkane: " << isomers[1][0][0] << endl;
-    for(int z=1;z<=isomers[1][0][0]; z++){
-      for(int y=1; y<=1; y++){ 
-	file << isomers[1][z][y];
+      for(int current_connection=0; current_connection<connections_n; current_connection++){    //for every connection this carbon atom has
+        morgan[digit]+=temp[graph.neighbor[digit][current_connection]];                         //add the value of the connected carbon atom to the current atoms Morgan's value
       }
-      file << endl;
     }
-    file.close();
-    isomers[1][1][0]=1;
+    iteration++;                                                                                //increment the amount of iterations done
   }
+}
 
-  if(generate_files) {
-    ofstream file(filenames[CarbonAmount].c_str());
-    file << "# Carbon atoms in this alkane: " << CarbonAmount << endl << "# Amount of isomers found for this alkane: " << isomers[CarbonAmount][0][0] << endl;
-    for(int z=1;z<=isomers[CarbonAmount][0][0]; z++){
-      for(int y=1; y<=CarbonAmount; y++){ 
-	file << isomers[CarbonAmount][z][y];
-      }
-      file << endl;
+
+
+//morgans_sort uses insertion sort to reorder the values stored for the current isomers morgan's code in the morgans vector. morgan[0] acts as sentinel. After this function is called, the code at
+//morgan[1...CarbonAmount] is sorted by value, beginning with the highest value
+
+void morgans_sort(int CarbonAmount, int morgan[]){
+
+  int main, compare;                                               //two positions on the code are initialized, the digit that moves, main, and the digits that main is compared to, compare
+
+  for(main=2; main<=CarbonAmount; main++) {                        //cycle through every digit of the code, beginning at 2 (first digit is "sorted" as it is the only digit up to current main)
+    morgan[0]=morgan[main];                                        //copy current value to position 0 to act as sentinel
+    compare=main;                                                  //initialize compare digit to be at the current main's position
+
+    while(morgan[0]>morgan[compare-1]){                            //while the values in front of main are less than the main's value
+      morgan[compare]=morgan[compare-1];                           //transfer the value in front to current position
+      compare--;                                                   //check for the next (previous) digit
     }
-    file.close();
+    morgan[compare]=morgan[0];                                     //if the previous digit is greater, insert digit at current position
   }
 }
+
+
+
+//isomer_key_batch appends all candidates collected in batch to candidates, together with the keys isomer_key would compute for them with mode morganKeys. Their Morgan's codes are computed together
+//by morgans_code_batch. Afterwards, the batch is empty.
+
+void isomer_key_batch(morgan_batch &batch, int CarbonAmount, chunk_keys &candidates){
+  int keys[morganLanes][maxCodeCarbons+2];
+  morgans_code_batch(batch, CarbonAmount, keys);
+
+  for(int lane=0; lane<batch.amount; lane++){
+    keys[lane][0] = batch.invariants[lane] ^ (batch.invariants[lane] >> 32);
+    candidates.codes.push_back(batch.codes[lane]);
+    candidates.keys.insert(candidates.keys.end(), keys[lane], keys[lane]+CarbonAmount+1);
+  }
+  batch.amount = 0;
+}
+
+
+
+//morgans_code_batch computes the sorted Morgan's codes of all candidates of batch at once and writes them to keys[candidate][1...CarbonAmount], exactly as morgans_code does for a single candidate.
+//The values are stored by atom with one 32 bit lane per candidate, so that one AVX2 instruction works on the same atom of all candidates. Missing bonds of atoms with less than 4 bonds point to atom 0,
+//whose value is always 0. Every iteration of Morgan's algorithm then collects the values of the 4 neighbors of an atom in all candidates with gather instructions and adds them. The values of every
+//candidate are finally sorted by the sorting network in batch.network, which compares the same two positions in all lanes with a single max and min instruction instead of branching like morgans_sort.
+//Empty lanes of an incomplete batch are calculated as well, but ignored.
+//This function may only be called if morgans_batch_supported returns TRUE.
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("avx2")))
+void morgans_code_batch(morgan_batch &batch, int CarbonAmount, int keys[][maxCodeCarbons+2]){
+  alignas(32) int values[2][(maxCodeCarbons+2)*morganLanes];                          //values[atom*morganLanes+lane] of the previous and the current iteration
+  alignas(32) int neighbors[(maxCodeCarbons+2)*4*morganLanes];                        //position of each neighbor's value in values, per atom, bond and lane
+
+  for(int index=0; index<(CarbonAmount+1)*morganLanes; index++){
+    values[0][index] = 0;
+    values[1][index] = 0;
+  }
+  for(int index=0; index<(CarbonAmount+1)*4*morganLanes; index++){
+    neighbors[index] = index%morganLanes;                                             //missing bonds point to atom 0
+  }
+
+  for(int lane=0; lane<batch.amount; lane++){                                         //the Morgan's code of the 0th iteration is the amount of bonds of every atom
+    alkane_graph &graph = batch.graphs[lane];
+    for(int atom=1; atom<=CarbonAmount; atom++){
+      values[0][atom*morganLanes+lane] = graph.degree[atom];
+      for(int bond=0; bond<graph.degree[atom]; bond++){
+        neighbors[(atom*4+bond)*morganLanes+lane] = graph.neighbor[atom][bond]*morganLanes+lane;
+      }
+    }
+  }
+
+  int current = 0;
+  for(int iteration=0; iteration<=(CarbonAmount/3); iteration++){                     //the same amount of iterations as morgans_algorithm
+    const int *previous = values[current];
+    current = 1-current;
+    for(int atom=1; atom<=CarbonAmount; atom++){
+      const __m256i *bonds = (const __m256i*)&neighbors[atom*4*morganLanes];
+      __m256i sum = _mm256_i32gather_epi32(previous, _mm256_load_si256(bonds), 4);
+      sum = _mm256_add_epi32(sum, _mm256_i32gather_epi32(previous, _mm256_load_si256(bonds+1), 4));
+      sum = _mm256_add_epi32(sum, _mm256_i32gather_epi32(previous, _mm256_load_si256(bonds+2), 4));
+      sum = _mm256_add_epi32(sum, _mm256_i32gather_epi32(previous, _mm256_load_si256(bonds+3), 4));
+      _mm256_store_si256((__m256i*)&values[current][atom*morganLanes], sum);
+    }
+  }
+
+  int *result = values[current];
+  for(size_t pair=0; pair<batch.network.size(); pair+=2){                              //sort the values of all lanes from the highest to the lowest
+    __m256i *first  = (__m256i*)&result[batch.network[pair]*morganLanes];
+    __m256i *second = (__m256i*)&result[batch.network[pair+1]*morganLanes];
+    __m256i a = _mm256_load_si256(first);
+    __m256i b = _mm256_load_si256(second);
+    _mm256_store_si256(first,  _mm256_max_epi32(a, b));
+    _mm256_store_si256(second, _mm256_min_epi32(a, b));
+  }
+
+  for(int lane=0; lane<batch.amount; lane++){
+    for(int atom=1; atom<=CarbonAmount; atom++){
+      keys[lane][atom] = result[atom*morganLanes+lane];
+    }
+  }
+}
+#else
+void morgans_code_batch(morgan_batch &batch, int CarbonAmount, int keys[][maxCodeCarbons+2]){
+  for(int lane=0; lane<batch.amount; lane++){
+    morgans_code(batch.graphs[lane], keys[lane]);
+  }
+}
+#endif
+
+
+
+//morgans_network stores the pairs of positions of Batcher's odd-even merge sort for the positions 1...CarbonAmount in network. Comparing each pair in order and moving the larger value to the first
+//position sorts any values from the highest to the lowest, just like morgans_sort. For icosane, this takes 103 comparisons.
+
+void morgans_network(int CarbonAmount, vector<int> &network){
+  network.clear();
+  for(int width=1; width<CarbonAmount; width*=2){
+    for(int distance=width; distance>=1; distance/=2){
+      for(int start=distance%width; start+distance<CarbonAmount; start+=2*distance){
+        for(int position=0; position<min(distance, CarbonAmount-start-distance); position++){
+          if((position+start)/(2*width)==(position+start+distance)/(2*width)) {
+            network.push_back(position+start+1);
+            network.push_back(position+start+distance+1);
+          }
+        }
+      }
+    }
+  }
+}
+
+
+
+//morgans_batch_supported returns TRUE if the processor supports the AVX2 instructions used by morgans_code_batch
+
+bool morgans_batch_supported(){
+#if defined(__x86_64__) || defined(__i386__)
+  return __builtin_cpu_supports("avx2");
+#else
+  return false;
+#endif
+}
+
+
+
+//check_morgan_uniqueness will look up the Morgan's code morgan with the given hash in the hash index of the Morgan's codes stored in morgans. Starting at the slot given by the hash, the slots are
+//probed linearly until either an empty slot or a slot with an identical code is found. A slot is only considered identical if its hash matches, its invariant at morgan[0] matches and, if
+//compareFullCodes is set, all digits of both codes match as well. If an empty slot is reached, the code is new: it is appended to morgans, inserted into this slot and TRUE is returned. This way, each
+//lookup costs O(1) instead of a scan over all previous isomers.
+
+int check_morgan_uniqueness(int morgan[], unsigned long long hash, int CarbonAmount, vector<int> &morgans, morgan_index &index){
+  int stride = CarbonAmount+1;
+  int mask = index.slots.size()-1;                                                                            //table size is a power of 2, so the slot can be obtained by masking
+  int slot = hash & mask;                                                                                     //first slot to be probed
+  index.lookups++;
+
+  while(index.slots[slot]!=-1){                                                                               //as long as the probed slot is occupied:
+    index.probes++;
+
+    if(index.hashes[slot]==hash){                                                                             //if the hashes are identical, the codes are most likely identical
+      int *twin = &morgans[(size_t)index.slots[slot]*stride];
+
+      if(morgan[0]!=twin[0]) {                                                                                //isomers with different invariants cannot be identical
+        index.filtered++;
+      } else {
+        int current_digit = 1;
+
+        while(compareFullCodes && (current_digit <= CarbonAmount) &&                                          //compare the full codes if requested
+              (morgan[current_digit]==twin[current_digit])){
+          current_digit++;
+        }
+
+        if(!compareFullCodes || current_digit>CarbonAmount){                                                  //if the codes are identical, an identical isomer has already been generated
+          index.duplicates++;
+          return 0;
+        }
+        index.collisions++;                                                                                   //otherwise the hashes collided and the next slot is checked
+      }
+    }
+    slot = (slot+1) & mask;
+  }
+
+  index.probes++;                                                                                             //the empty slot was inspected as well
+  index.slots[slot] = morgans.size()/stride;                                                                  //the code is unique, append it to morgans and insert it into the empty slot
+  morgans.insert(morgans.end(), morgan, morgan+stride);
+  index.hashes[slot] = hash;
+  index.used++;
+
+  if(2*index.used > (int)index.slots.size()){                                                                 //keep the load factor below 50% to keep the probe sequences short
+    morgan_index_grow(index);
+  }
+  return 1;
+}
+
+
+
+//isomer_invariant summarizes the connectivity of an isomer in a single number, which is identical for identical isomers no matter how they are numbered: the amounts of secondary, tertiary and
+//quaternary carbon atoms and the amounts of bonds between each two kinds of atoms (e.g. primary-tertiary), each stored in 5 bits (see function invariant_change). The amounts of primary atoms and of
+//bonds between two primary atoms are left out, as they follow from the others or only occur in ethane. The root of a canonical isomer code is one of the atoms with the most bonds, so its value is
+//contained in these amounts as well. Many different isomers share their invariant, so it can only tell isomers apart, not prove them identical. It is only used together with Morgan's codes.
+
+unsigned long long isomer_invariant(alkane_graph &graph){
+  unsigned long long invariant = 0;
+
+  for(int atom=1; atom<=graph.atoms; atom++){
+    invariant_change(invariant, graph.degree[atom], 0, 1);
+    for(int bond=0; bond<graph.degree[atom]; bond++){
+      int neighbor = graph.neighbor[atom][bond];
+      if(atom<neighbor) {
+        invariant_change(invariant, graph.degree[atom], graph.degree[neighbor], 1);
+      }
+    }
+  }
+  return invariant;
+}
+
+
+
+//invariant_add_leaf returns the invariant of the isomer obtained by attaching a new end group to carbon C of parent (see function graph_add_leaf), given the invariant of parent. Only carbon C changes
+//its kind, so only its own amount and the amounts of its bonds have to be corrected, which takes a few additions instead of a pass over all bonds.
+
+unsigned long long invariant_add_leaf(unsigned long long invariant, alkane_graph &parent, int C){
+  int degree = parent.degree[C];
+
+  invariant_change(invariant, degree, 0, -1);
+  invariant_change(invariant, degree+1, 0, 1);
+  for(int bond=0; bond<degree; bond++){
+    int neighbor_degree = parent.degree[parent.neighbor[C][bond]];
+    invariant_change(invariant, degree, neighbor_degree, -1);
+    invariant_change(invariant, degree+1, neighbor_degree, 1);
+  }
+  invariant_change(invariant, degree+1, 1, 1);                                        //bond to the new end group
+  return invariant;
+}
+
+
+
+//invariant_change adds change to the amount of atoms with first bonds (if second is 0) or to the amount of bonds between atoms with first and second bonds stored in invariant. As no amount
+//exceeds 31 carbon atoms, each one fits into its own 5 bits: the atoms with 2, 3 and 4 bonds take bits 0-14, followed by the 9 kinds of bonds from primary-secondary to quaternary-quaternary.
+
+void invariant_change(unsigned long long &invariant, int first, int second, int change){
+  int field;
+  if(second==0) {
+    if(first<2) {
+      return;
+    }
+    field = first-2;
+  } else {
+    int lower = min(first, second);
+    int upper = max(first, second);
+    if(upper<2) {
+      return;
+    }
+    int first_field[5] = {0, 0, 3, 6, 8};                                             //field of the first bond kind starting with atoms of lower bonds
+    field = 3+first_field[lower]+upper-max(lower, 2);
+  }
+  invariant += (unsigned long long)(long long)change << (5*field);
+}
+
+
+
+//CANONICAL FUNCTION GROUP
+
+//canonical_code translates an isomer code into an exact canonical code at canonical[1...CarbonAmount]. Two isomer codes have the same canonical code if and only if they describe the same alkane, so unlike
+//the Morgan's code, no two different isomers can be mistaken for each other and no identical isomers can be told apart.
+//The canonical code is written in the same notation as the isomer codes generated by generate_Isomers: every digit is the amount of forward connections of an atom, in the order of a depth-first walk
+//starting at the root. However, the root is chosen to be the center of the tree, the atom (or one of the two bonded atoms) found last when removing all end groups over and over again, which does not depend
+//on how the alkane is drawn. Starting at the center, the branches of every atom are ordered by their own canonical code (AHU algorithm, see function canonical_subtree). If there are two centers, the tree
+//is written starting at both of them and the larger code is taken.
+//The connectivity is obtained by code_to_graph, which reads the isomer code in a single pass, or by graph_add_leaf from the connectivity of the parent isomer.
+
+void canonical_code(alkane_graph &graph, int canonical[]){
+
+  int CarbonAmount = graph.atoms;
+  int centers[2];
+  int center_amount = graph_centers(graph, centers);
+
+  canonical_subtree(graph, centers[0], 0, canonical+1);                               //write the tree starting at the (first) center
+
+  if(center_amount==2) {                                                              //if there is a second center, write the tree starting there and keep the larger code
+    int second[maxCodeCarbons+1];
+    canonical_subtree(graph, centers[1], 0, second);
+    if(compare_codes(second, canonical+1, CarbonAmount)>0) {
+      for(int digit=0; digit<CarbonAmount; digit++){
+        canonical[digit+1] = second[digit];
+      }
+    }
+  }
+}
+
+
+
+//code_to_graph determines the connectivity of an isomer code in a single pass. As the code lists the atoms in the order of a depth-first walk, every atom is bonded to the latest atom before it that still
+//has open forward connections. These atoms are kept on a stack together with the amount of forward connections that are still open, so unlike morgans_splicing, no foreign connections have to be counted.
+
+void code_to_graph(isomer_code code, int CarbonAmount, alkane_graph &graph){
+  int digits[maxCodeCarbons+2];
+  int stack[maxCodeCarbons+2];                                                        //atoms with open forward connections
+  int open[maxCodeCarbons+2];                                                         //amount of open forward connections of these atoms
+  int stack_size = 0;
+
+  isomer_unpack(code, CarbonAmount, digits);
+  graph.atoms = CarbonAmount;
+
+  for(int atom=1; atom<=CarbonAmount; atom++){
+    graph.degree[atom] = 0;
+
+    if(stack_size>0) {                                                                //bond the atom to the latest atom with an open forward connection
+      int parent = stack[stack_size-1];
+      graph.neighbor[parent][graph.degree[parent]++] = atom;
+      graph.neighbor[atom][graph.degree[atom]++] = parent;
+      if(--open[stack_size-1]==0) {                                                   //if all forward connections of this atom are found, it is removed from the stack
+        stack_size--;
+      }
+    }
+
+    if(digits[atom]>0) {                                                              //if the atom has forward connections itself, the following atoms are bonded to it first
+      stack[stack_size] = atom;
+      open[stack_size] = digits[atom];
+      stack_size++;
+    }
+  }
+}
+
+
+
+//graph_add_leaf derives the connectivity of the isomer obtained by attaching a new end group to carbon C of parent (see function isomer_extend) and stores it in child. The new atom takes number C+1,
+//so every atom behind C is moved up by one, together with every bond pointing to it. This copies each bond once instead of reading the whole code of the child again.
+
+void graph_add_leaf(alkane_graph &parent, int C, alkane_graph &child){
+  child.atoms = parent.atoms+1;
+
+  for(int atom=1; atom<=parent.atoms; atom++){
+    int moved = (atom<=C) ? atom : atom+1;                                            //new number of this atom
+    child.degree[moved] = parent.degree[atom];
+    for(int bond=0; bond<parent.degree[atom]; bond++){
+      int neighbor = parent.neighbor[atom][bond];
+      child.neighbor[moved][bond] = (neighbor<=C) ? neighbor : neighbor+1;
+    }
+  }
+
+  child.neighbor[C][child.degree[C]++] = C+1;                                         //bond between carbon C and the new end group
+  child.degree[C+1] = 1;
+  child.neighbor[C+1][0] = C;
+}
+
+
+
+//graph_centers finds the center of the tree by removing all end groups (atoms with a single bond) layer by layer, until only one atom or two bonded atoms remain. Every atom is removed once, so this takes
+//linear time. The centers are written to centers[] and their amount (1 or 2) is returned.
+
+int graph_centers(alkane_graph &graph, int centers[]){
+  int remaining_degree[maxCodeCarbons+2];
+  int layer[maxCodeCarbons+2];                                                        //atoms removed in the current layer
+  int layer_size = 0;
+  int remaining = graph.atoms;
+
+  for(int atom=1; atom<=graph.atoms; atom++){                                         //the first layer are all end groups
+    remaining_degree[atom] = graph.degree[atom];
+    if(remaining_degree[atom]<=1) {
+      layer[layer_size++] = atom;
+    }
+  }
+
+  while(remaining>2) {                                                                //as long as more than two atoms remain, remove the current layer
+    int next_layer[maxCodeCarbons+2];
+    int next_size = 0;
+    remaining -= layer_size;
+
+    for(int leaf=0; leaf<layer_size; leaf++){
+      int atom = layer[leaf];
+      for(int bond=0; bond<graph.degree[atom]; bond++){                               //every neighbor loses a bond and becomes an end group of the next layer if it has only one left
+        int neighbor = graph.neighbor[atom][bond];
+        if(--remaining_degree[neighbor]==1) {
+          next_layer[next_size++] = neighbor;
+        }
+      }
+    }
+
+    for(int leaf=0; leaf<next_size; leaf++){
+      layer[leaf] = next_layer[leaf];
+    }
+    layer_size = next_size;
+  }
+
+  for(int center=0; center<layer_size; center++){
+    centers[center] = layer[center];
+  }
+  return layer_size;
+}
+
+
+
+//canonical_subtree writes the canonical code of the branch starting at atom, which is bonded to parent (0 for the root), into code[] and returns its length. The first digit is the amount of forward
+//connections of atom, followed by the canonical codes of its branches ordered from the largest to the smallest. As a code written this way always ends exactly where its last branch ends, no code can be the
+//beginning of a different code, so comparing two codes digit by digit is enough to order them.
+
+int canonical_subtree(alkane_graph &graph, int atom, int parent, int code[]){
+  int branches[4][maxCodeCarbons+1];                                                  //canonical codes of the branches of this atom
+  int lengths[4];
+  int order[4];
+  int branch_amount = 0;
+
+  for(int bond=0; bond<graph.degree[atom]; bond++){                                   //write the code of every branch, except for the one leading back to parent
+    int neighbor = graph.neighbor[atom][bond];
+    if(neighbor!=parent) {
+      lengths[branch_amount] = canonical_subtree(graph, neighbor, atom, branches[branch_amount]);
+      order[branch_amount] = branch_amount;
+      branch_amount++;
+    }
+  }
+
+  for(int main=1; main<branch_amount; main++){                                        //order the branches from the largest to the smallest code using insertion sort
+    int moving = order[main];
+    int compare = main;
+    while(compare>0 && compare_codes(branches[moving], branches[order[compare-1]], min(lengths[moving], lengths[order[compare-1]]))>0) {
+      order[compare] = order[compare-1];
+      compare--;
+    }
+    order[compare] = moving;
+  }
+
+  int length = 0;
+  code[length++] = branch_amount;
+  for(int branch=0; branch<branch_amount; branch++){                                  //write the branches in their canonical order behind the amount of forward connections
+    for(int digit=0; digit<lengths[order[branch]]; digit++){
+      code[length++] = branches[order[branch]][digit];
+    }
+  }
+  return length;
+}
+
+
+
+//compare_codes compares the first length digits of two codes and returns a positive value if first is larger, a negative value if second is larger and 0 if they are identical
+
+int compare_codes(int first[], int second[], int length){
+  for(int digit=0; digit<length; digit++){
+    if(first[digit]!=second[digit]) {
+      return first[digit]-second[digit];
+    }
+  }
+  return 0;
+}
+
+
+
+//ORDERLY FUNCTION GROUP
+
+//orderly_Isomers counts all isomers from methane to lastCarbon with orderly_generate and prints the table of amounts once all alkanes are done. The walk is started from methane up to orderlySplitCarbon on
+//a single thread, which collects all isomers of orderlySplitCarbon. The worker threads then continue the walk from these isomers, each taking the next free one, and count separately. As every isomer is
+//generated exactly once no matter where the walk starts, the sums of all counts are the amounts of isomers.
+
+void orderly_Isomers(){
+  vector<long long> counts(lastCarbon+1, 0);
+  vector<alkane_graph> starts;
+  alkane_graph methane;
+  methane.atoms = 1;
+  methane.degree[1] = 0;
+
+  int start_carbon = min(orderlySplitCarbon, lastCarbon);
+  orderly_generate(methane, lastCarbon, counts, &starts, start_carbon);
+
+  int workers = worker_count();
+  vector<vector<long long> > worker_counts(workers, vector<long long>(lastCarbon+1, 0));
+  atomic<int> next_start(0);
+
+  run_workers(workers, [&](int worker){
+    for(int start=next_start++; start<(int)starts.size(); start=next_start++){
+      orderly_generate(starts[start], lastCarbon, worker_counts[worker], NULL, 0);
+    }
+  });
+
+  cout << endl;
+  cout << "n \t" << "#isomers" << endl;
+  cout << "____________________________________" << endl;
+  for(int CarbonAmount=1; CarbonAmount<=lastCarbon; CarbonAmount++){
+    for(int worker=0; worker<workers; worker++){
+      counts[CarbonAmount] += worker_counts[worker][CarbonAmount];
+    }
+    if(CarbonAmount>=firstCarbon) {
+      cout << CarbonAmount << " \t" << counts[CarbonAmount] << endl;
+    }
+  }
+}
+
+
+
+//orderly_generate counts the isomer in graph and walks on to every isomer with one more carbon atom whose canonical parent it is (canonical augmentation). A child is obtained by attaching a new end
+//group to an atom with less than 4 bonds. It is only accepted if the new end group is a canonical end group of the child (see function orderly_check_leaf), which means that removing a canonical end group of
+//the child leads back to this parent. Therefore, every isomer is reached from exactly one parent. Attaching to equivalent atoms of the same parent leads to identical children, so a child is also
+//dropped if one of its siblings with the same canonical code was accepted before. This needs no list of the isomers found so far: the memory used only grows with the height of the walk, which is at most
+//last atoms.
+//If starts is given, the walk stops at the isomers with start_carbon atoms, which are collected in starts instead of being counted.
+
+void orderly_generate(alkane_graph &graph, int last, vector<long long> &counts, vector<alkane_graph> *starts, int start_carbon){
+  int atoms = graph.atoms;
+
+  if(starts!=NULL && atoms==start_carbon) {
+    starts->push_back(graph);
+    return;
+  }
+
+  counts[atoms]++;
+  if(atoms==last) {
+    return;
+  }
+
+  orderly_sibling siblings[maxCodeCarbons+1];                                         //canonical codes of the children accepted so far
+  int sibling_amount = 0;
+  int leaf = atoms+1;
+
+  for(int atom=1; atom<=atoms; atom++){                                               //for every atom with less than 4 bonds:
+    if(graph.degree[atom]==4) {
+      continue;
+    }
+
+    graph.neighbor[atom][graph.degree[atom]++] = leaf;                                //attach a new end group
+    graph.degree[leaf] = 1;
+    graph.neighbor[leaf][0] = atom;
+    graph.atoms = leaf;
+
+    int canonical[maxCodeCarbons+1];
+    if(orderly_check_leaf(graph, leaf, canonical)) {                                  //if the new end group is canonical and the child is new among its siblings, continue the walk with the child
+      int sibling = 0;
+      while(sibling<sibling_amount && compare_codes(siblings[sibling].code, canonical, leaf)!=0) {
+        sibling++;
+      }
+
+      if(sibling==sibling_amount) {
+        for(int digit=0; digit<leaf; digit++){
+          siblings[sibling_amount].code[digit] = canonical[digit];
+        }
+        sibling_amount++;
+        orderly_generate(graph, last, counts, starts, start_carbon);
+      }
+    }
+
+    graph.atoms = atoms;                                                              //remove the end group again
+    graph.degree[atom]--;
+  }
+}
+
+
+
+//orderly_check_leaf returns TRUE if leaf is a canonical end group of graph and writes the canonical code of graph (see function canonical_code) into canonical[].
+//The canonical end groups are the atoms that can appear as the last of the atoms farthest from the center when the tree is written as its canonical code. As equal branches may be written in any order,
+//these are all atoms equivalent to this last atom, which does not depend on how the isomer was built. To find them, the tree is written starting at the center by orderly_subtree, which also tells whether
+//leaf can take the place of this last atom. If there are two centers with identical codes, the tree can be written starting at either of them.
+//As the last atom is always farthest from the center, leaf is rejected right away if it is not, which spares writing the canonical code of most children.
+
+int orderly_check_leaf(alkane_graph &graph, int leaf, int canonical[]){
+  int centers[2];
+  int center_amount = graph_centers(graph, centers);
+  int distance[maxCodeCarbons+2];                                                     //distance of every atom to the closest center
+  int queue[maxCodeCarbons+2];
+  int queue_size = 0;
+  int height = 0;
+
+  for(int atom=1; atom<=graph.atoms; atom++){
+    distance[atom] = -1;
+  }
+  for(int center=0; center<center_amount; center++){
+    distance[centers[center]] = 0;
+    queue[queue_size++] = centers[center];
+  }
+  for(int position=0; position<queue_size; position++){                               //breadth-first search starting at the centers
+    int atom = queue[position];
+    height = distance[atom];
+    for(int bond=0; bond<graph.degree[atom]; bond++){
+      int neighbor = graph.neighbor[atom][bond];
+      if(distance[neighbor]==-1) {
+        distance[neighbor] = distance[atom]+1;
+        queue[queue_size++] = neighbor;
+      }
+    }
+  }
+
+  if(distance[leaf]!=height) {                                                        //the leaf has to be one of the atoms farthest from the center
+    return 0;
+  }
+
+  int has_deepest, is_last;
+  orderly_subtree(graph, centers[0], 0, distance, height, leaf, canonical, has_deepest, is_last);
+
+  if(center_amount==2) {                                                              //if there is a second center, write the tree starting there and keep the larger code
+    int second[maxCodeCarbons+1];
+    int second_last;
+    orderly_subtree(graph, centers[1], 0, distance, height, leaf, second, has_deepest, second_last);
+    int comparison = compare_codes(second, canonical, graph.atoms);
+
+    if(comparison>0) {
+      for(int digit=0; digit<graph.atoms; digit++){
+        canonical[digit] = second[digit];
+      }
+      is_last = second_last;
+    } else if(comparison==0) {
+      is_last = is_last || second_last;
+    }
+  }
+  return is_last;
+}
+
+
+
+//orderly_subtree writes the canonical code of the branch starting at atom, bonded to parent, into code[] and returns its length, just like canonical_subtree. In addition, has_deepest is set if the branch
+//contains an atom at distance height from the center, and is_last is set if leaf can be the last of these atoms in the canonical code of this branch. This is the case if leaf is atom itself, or if leaf
+//lies in a branch whose code is identical to the code of the last branch containing such an atom, and leaf can be the last of them in its own branch as well.
+
+int orderly_subtree(alkane_graph &graph, int atom, int parent, int distance[], int height, int leaf, int code[], int &has_deepest, int &is_last){
+  int branches[4][maxCodeCarbons+1];
+  int lengths[4];
+  int deepest[4];
+  int order[4];
+  int leaf_branch = -1;                                                               //branch leaf can be the last deepest atom of, if any
+  int branch_amount = 0;
+
+  for(int bond=0; bond<graph.degree[atom]; bond++){
+    int neighbor = graph.neighbor[atom][bond];
+    if(neighbor!=parent) {
+      int branch_last;
+      lengths[branch_amount] = orderly_subtree(graph, neighbor, atom, distance, height, leaf, branches[branch_amount], deepest[branch_amount], branch_last);
+      if(branch_last) {
+        leaf_branch = branch_amount;
+      }
+      order[branch_amount] = branch_amount;
+      branch_amount++;
+    }
+  }
+
+  for(int main=1; main<branch_amount; main++){                                        //order the branches from the largest to the smallest code using insertion sort
+    int moving = order[main];
+    int compare = main;
+    while(compare>0 && compare_codes(branches[moving], branches[order[compare-1]], min(lengths[moving], lengths[order[compare-1]]))>0) {
+      order[compare] = order[compare-1];
+      compare--;
+    }
+    order[compare] = moving;
+  }
+
+  int length = 0;
+  code[length++] = branch_amount;
+  has_deepest = (distance[atom]==height);
+  is_last = (atom==leaf);
+  int last_deepest = -1;                                                              //last branch in canonical order that contains an atom farthest from the center
+
+  for(int branch=0; branch<branch_amount; branch++){
+    for(int digit=0; digit<lengths[order[branch]]; digit++){
+      code[length++] = branches[order[branch]][digit];
+    }
+    if(deepest[order[branch]]) {
+      last_deepest = order[branch];
+      has_deepest = 1;
+    }
+  }
+
+  if(leaf_branch!=-1 && lengths[leaf_branch]==lengths[last_deepest] &&                //leaf can be last if its branch can take the place of the last branch with such an atom
+     compare_codes(branches[leaf_branch], branches[last_deepest], lengths[leaf_branch])==0) {
+    is_last = 1;
+  }
+  return length;
+}
+
+
+
+//DESCRIPTOR FUNCTION GROUP
+
+//describe_isomer appends one line of comma separated values to row: the isomer code, followed by the descriptors chosen in descriptorSet, in the order of the columns written by open_descriptor_file.
+//graph has to be the connectivity of code as determined by code_to_graph.
+//  wiener     Wiener index, the sum of the distances between all pairs of carbon atoms (see function wiener_index)
+//  randic     Randic connectivity index, the sum of 1/sqrt(d1*d2) over all bonds, where d1 and d2 are the amounts of carbon atoms bonded to the two atoms (see function randic_index)
+//  branching  amounts of primary, secondary, tertiary and quaternary carbon atoms, which are bonded to 1, 2, 3 and 4 carbon atoms
+//  smiles     SMILES string of the carbon skeleton, written starting at the root of the isomer code (see function smiles_branch)
+
+void describe_isomer(alkane_graph &graph, isomer_code code, string &row){
+  for(int digit=1; digit<=graph.atoms; digit++){
+    row += (char)('0'+isomer_digit(code, digit));
+  }
+
+  if(descriptorSet & wienerDescriptor) {
+    row += ',';
+    row += to_string(wiener_index(graph));
+  }
+  if(descriptorSet & randicDescriptor) {
+    char randic[32];
+    snprintf(randic, sizeof(randic), ",%.6f", randic_index(graph));
+    row += randic;
+  }
+  if(descriptorSet & branchingDescriptor) {
+    int carbons[5] = {0, 0, 0, 0, 0};
+    for(int atom=1; atom<=graph.atoms; atom++){
+      carbons[graph.degree[atom]]++;
+    }
+    for(int degree=1; degree<=4; degree++){
+      row += ',';
+      row += to_string(carbons[degree]);
+    }
+  }
+  if(descriptorSet & smilesDescriptor) {
+    row += ',';
+    smiles_branch(graph, 1, 0, row);
+  }
+  row += '\n';
+}
+
+
+
+//wiener_index returns the Wiener index of graph. In a tree, every bond lies on the paths between the atoms on its two sides, so the index is the sum of size*(atoms-size) over all bonds, where size is the
+//amount of atoms in the branch behind the bond. code_to_graph numbers the atoms in the order of the isomer code, so every atom but the root is bonded to exactly one atom with a smaller number, and the
+//branch sizes are summed up from the last atom to the first.
+
+int wiener_index(alkane_graph &graph){
+  int size[maxCodeCarbons+2];
+  int wiener = 0;
+
+  for(int atom=1; atom<=graph.atoms; atom++){
+    size[atom] = 1;
+  }
+  for(int atom=graph.atoms; atom>=2; atom--){
+    int parent = atom;
+    for(int bond=0; bond<graph.degree[atom]; bond++){
+      parent = min(parent, graph.neighbor[atom][bond]);
+    }
+    size[parent] += size[atom];
+    wiener += size[atom]*(graph.atoms-size[atom]);
+  }
+  return wiener;
+}
+
+
+
+//randic_index returns the Randic connectivity index of graph. Every bond is visited from both of its atoms, so half of the sum is taken.
+
+double randic_index(alkane_graph &graph){
+  double randic = 0;
+
+  for(int atom=1; atom<=graph.atoms; atom++){
+    for(int bond=0; bond<graph.degree[atom]; bond++){
+      randic += 1/sqrt((double)(graph.degree[atom]*graph.degree[graph.neighbor[atom][bond]]));
+    }
+  }
+  return randic/2;
+}
+
+
+
+//smiles_branch appends the SMILES string of the branch starting at atom, bonded to parent, to smiles. Every branch but the last one of an atom is put in parentheses.
+
+void smiles_branch(alkane_graph &graph, int atom, int parent, string &smiles){
+  smiles += 'C';
+  int left = graph.degree[atom]-(parent!=0);                                          //branches not written yet
+
+  for(int bond=0; bond<graph.degree[atom]; bond++){
+    int neighbor = graph.neighbor[atom][bond];
+    if(neighbor==parent) {
+      continue;
+    }
+    left--;
+    if(left>0) {
+      smiles += '(';
+      smiles_branch(graph, neighbor, atom, smiles);
+      smiles += ')';
+    } else {
+      smiles_branch(graph, neighbor, atom, smiles);
+    }
+  }
+}
+
+
+
+//read_descriptor_set reads a comma separated list of descriptor names (wiener, randic, branching, smiles or all) into set. FALSE is returned, and set is left alone, if a name is unknown.
+
+bool read_descriptor_set(string list, int &set){
+  int chosen = 0;
+  size_t start = 0;
+
+  while(start<=list.size()) {
+    size_t end = list.find(',', start);
+    if(end==string::npos) {
+      end = list.size();
+    }
+    string name = list.substr(start, end-start);
+    if(name=="wiener") {
+      chosen |= wienerDescriptor;
+    } else if(name=="randic") {
+      chosen |= randicDescriptor;
+    } else if(name=="branching") {
+      chosen |= branchingDescriptor;
+    } else if(name=="smiles") {
+      chosen |= smilesDescriptor;
+    } else if(name=="all") {
+      chosen |= wienerDescriptor | randicDescriptor | branchingDescriptor | smilesDescriptor;
+    } else {
+      return false;
+    }
+    start = end+1;
+  }
+  set = chosen;
+  return true;
+}
+
+
+
+//open_descriptor_file opens the descriptor file filename under a temporary name and writes the captions of the columns chosen in descriptorSet. Once all rows are written, close_descriptor_file gives
+//the file its name, so that only complete descriptor files appear. FALSE is returned, and an error printed, if the file could not be opened.
+
+bool open_descriptor_file(ofstream &file, string filename){
+  file.open((filename+".partial").c_str());
+  if(!file.is_open()) {
+    cerr << "Could not write " << filename << "." << endl;
+    return false;
+  }
+  file << "code";
+  if(descriptorSet & wienerDescriptor) {
+    file << ",wiener";
+  }
+  if(descriptorSet & randicDescriptor) {
+    file << ",randic";
+  }
+  if(descriptorSet & branchingDescriptor) {
+    file << ",primary,secondary,tertiary,quaternary";
+  }
+  if(descriptorSet & smilesDescriptor) {
+    file << ",smiles";
+  }
+  file << "\n";
+  return true;
+}
+
+
+
+//close_descriptor_file closes the descriptor file opened by open_descriptor_file and renames it to filename. FALSE is returned if the file could not be written (see function finish_partial_file).
+
+bool close_descriptor_file(ofstream &file, string filename){
+  return finish_partial_file(file, filename+".partial", filename);
+}
+
+
+
+//write_descriptor_file writes the descriptor file filename for an alkane that is not generated by generate_Isomers, i.e. methane or the alkane a run was resumed from, whose codes are all in memory.
+//The connectivity of every isomer is determined by code_to_graph. Like in write_isomer_file, the rows are written in blocks of about 1MB. FALSE is returned if the file could not be written.
+
+bool write_descriptor_file(vector<isomer_code> &codes, int CarbonAmount, string filename){
+  ofstream file;
+  if(!open_descriptor_file(file, filename)) {
+    return false;
+  }
+
+  alkane_graph graph;
+  string rows;
+  for(size_t isomer=0; isomer<codes.size(); isomer++){
+    code_to_graph(codes[isomer], CarbonAmount, graph);
+    describe_isomer(graph, codes[isomer], rows);
+
+    if(rows.size() >= (1<<20)) {
+      file.write(rows.data(), rows.size());
+      rows.clear();
+    }
+  }
+  file.write(rows.data(), rows.size());
+  return close_descriptor_file(file, filename);
+}
+
+
+
+//descriptor_filename returns the name of the descriptor file of the alkane with CarbonAmount carbon atoms in directory
+
+string descriptor_filename(string directory, int CarbonAmount){
+  return directory+"/"+to_string(CarbonAmount)+".descriptors.csv";
+}
+
+
+
+//SHARD FUNCTION GROUP
+
+//shard_Isomers generates one shard of the alkane with lastCarbon carbon atoms, so that a large alkane can be spread across several processes or machines sharing outputDirectory. The previous
+//alkane is read from its isomer file in outputDirectory, which has to be complete (see function resume_level). Only the parents shard, shard+shards, shard+2*shards... are extended, in the same way
+//as generate_chunk extends them, and every child is keyed by its canonical code. Of all identical children, only the one generated first is kept (see function compact_records), together with the
+//position at which it was generated. The children are written to the shard file in the order of their keys, which merge_Isomers relies on.
+//The children are kept unsorted until there are twice as many as after the last time they were compacted, so a shard never holds much more than its own share of the alkane's isomers. Returns 0 if the
+//shard file was written and 1 otherwise, so it can be used as exit status.
+
+int shard_Isomers(int shard, int shards){
+  int CarbonAmount = lastCarbon;
+  int previousC = CarbonAmount-1;
+  vector<big_number> rooted;
+  count_rooted_trees(rooted, CarbonAmount);
+
+  vector<isomer_code> parents;
+  string parent_filename = isomer_filename(outputDirectory, previousC);
+  if(read_isomer_file(parent_filename, previousC, parents)!=previousC || parents.size()!=big_to_integer(count_alkanes(rooted, previousC))) {
+    cerr << "No complete isomer file " << parent_filename << " found to generate shard " << shard << "/" << shards << " of C" << CarbonAmount << " from." << endl;
+    return 1;
+  }
+
+  vector<shard_record> records;
+  size_t compact_size = 1<<16;                                                        //amount of records at which the records are compacted next
+  alkane_graph parent_graph, candidate_graph;
+  int canonical[maxCodeCarbons+2];
+
+  for(size_t I=shard; I<parents.size(); I+=shards){                                   //for all parents of this shard
+    isomer_code parent = parents[I];
+    code_to_graph(parent, previousC, parent_graph);
+
+    for(int C=1; C<=previousC; C++){                                                  //for every carbon atom of this isomer that can be extended
+      if(!Isomer_digit_validity_check(parent, C)) {
+        continue;
+      }
+      graph_add_leaf(parent_graph, C, candidate_graph);
+      canonical_code(candidate_graph, canonical);
+
+      shard_record record;
+      record.key = isomer_pack(canonical, CarbonAmount);
+      record.occurrence = (unsigned long long)I*32+C;
+      record.code = isomer_extend(parent, C);
+      records.push_back(record);
+    }
+
+    if(records.size()>=compact_size) {
+      compact_records(records);
+      compact_size = max(compact_size, 2*records.size());
+    }
+  }
+  compact_records(records);
+
+  string filename = shard_filename(outputDirectory, CarbonAmount, shard, shards);
+  if(!write_shard_file(records, CarbonAmount, shard, shards, filename)) {
+    return 1;
+  }
+  cout << "Shard " << shard << "/" << shards << " of C" << CarbonAmount << ": " << records.size() << " isomers written to " << filename
+       << " (peak memory " << peak_memory() << " kB)." << endl;
+  return 0;
+}
+
+
+
+//merge_Isomers merges the shard files 0...shards-1 of the alkane with lastCarbon carbon atoms, as written by shard_Isomers, into its isomer file in outputDirectory in the format given by outputFormat.
+//As every shard file is ordered by key, identical isomers of different shards meet at the heads of the files (k-way merge), and only the one generated first is kept. Afterwards, the isomers are put
+//back into the order of their generation, which is exactly the order a single run of generate_Isomers stores them in, so the isomer file is identical to the one written without shards.
+//The file is only written if all shard files are complete and the amount of isomers is the one count_alkanes computes. Once it is written, the shard files are removed. Returns 0 if it was written and
+//1 otherwise, in which case the shard files stay in place.
+
+int merge_Isomers(int shards){
+  int CarbonAmount = lastCarbon;
+  vector<ifstream> files(shards);
+  vector<long long> left(shards);                                                     //records of every shard file not read yet, including its head
+  vector<shard_record> heads(shards);
+
+  for(int shard=0; shard<shards; shard++){
+    string filename = shard_filename(outputDirectory, CarbonAmount, shard, shards);
+    if(!open_shard_file(filename, CarbonAmount, shard, shards, files[shard], left[shard])) {
+      cerr << "No complete shard file " << filename << " found." << endl;
+      return 1;
+    }
+    if(left[shard]>0) {
+      read_shard_record(files[shard], heads[shard]);
+    }
+  }
+
+  vector<shard_record> merged;
+  while(true) {
+    int smallest = -1;                                                                //shard file with the smallest key at its head, generated first among equal keys
+    for(int shard=0; shard<shards; shard++){
+      if(left[shard]>0 && (smallest==-1 || heads[shard].key<heads[smallest].key ||
+                           (heads[shard].key==heads[smallest].key && heads[shard].occurrence<heads[smallest].occurrence))) {
+        smallest = shard;
+      }
+    }
+    if(smallest==-1) {
+      break;
+    }
+
+    shard_record first = heads[smallest];
+    merged.push_back(first);
+    for(int shard=0; shard<shards; shard++){                                          //drop the isomer from the heads of all shard files, which hold it at most once each
+      if(left[shard]>0 && heads[shard].key==first.key) {
+        left[shard]--;
+        if(left[shard]>0) {
+          read_shard_record(files[shard], heads[shard]);
+        }
+      }
+    }
+  }
+
+  for(int shard=0; shard<shards; shard++){
+    if(!files[shard]) {
+      cerr << "Shard file " << shard_filename(outputDirectory, CarbonAmount, shard, shards) << " is not complete." << endl;
+      return 1;
+    }
+  }
+
+  vector<big_number> rooted;
+  count_rooted_trees(rooted, CarbonAmount);
+  unsigned long long expected = big_to_integer(count_alkanes(rooted, CarbonAmount));
+  if(merged.size()!=expected) {
+    cerr << "The shard files of C" << CarbonAmount << " hold " << merged.size() << " isomers instead of " << expected << "." << endl;
+    return 1;
+  }
+
+  sort(merged.begin(), merged.end(), [](const shard_record &first, const shard_record &second){
+    return first.occurrence<second.occurrence;
+  });
+  vector<isomer_code> codes(merged.size());
+  for(size_t isomer=0; isomer<merged.size(); isomer++){
+    codes[isomer] = merged[isomer].code;
+  }
+  vector<shard_record>().swap(merged);
+
+  string filename = isomer_filename(outputDirectory, CarbonAmount);
+  if(!write_isomer_file(codes, CarbonAmount, filename)) {
+    return 1;
+  }
+  for(int shard=0; shard<shards; shard++){                                            //the shard files are not needed anymore
+    files[shard].close();
+    remove(shard_filename(outputDirectory, CarbonAmount, shard, shards).c_str());
+  }
+  cout << CarbonAmount << " \t" << codes.size() << " isomers merged from " << shards << " shard files into " << filename << "." << endl;
+  return 0;
+}
+
+
+
+//compact_records orders the records by key and keeps only the record generated first of every key
+
+void compact_records(vector<shard_record> &records){
+  sort(records.begin(), records.end(), [](const shard_record &first, const shard_record &second){
+    return first.key<second.key || (first.key==second.key && first.occurrence<second.occurrence);
+  });
+  records.erase(unique(records.begin(), records.end(), [](const shard_record &first, const shard_record &second){
+    return first.key==second.key;
+  }), records.end());
+}
+
+
+
+//write_shard_file writes the records as shard file (see struct shard_record) to filename. The whole file is assembled in memory and written in a single write. Like isomer files, it is written under a
+//temporary name and renamed once it is complete. FALSE is returned if the file could not be written (see function finish_partial_file).
+
+bool write_shard_file(vector<shard_record> &records, int CarbonAmount, int shard, int shards, string filename){
+  vector<unsigned char> buffer(32+24*records.size(), 0);
+  memcpy(&buffer[0], "ALKSHARD", 8);                                                  //header
+  unsigned long long fields[5] = {1, (unsigned long long)CarbonAmount, (unsigned long long)records.size(), (unsigned long long)shard, (unsigned long long)shards};
+  int offsets[5] = {8, 12, 16, 24, 28};
+  int sizes[5]   = {4, 4, 8, 4, 4};
+  for(int field=0; field<5; field++){
+    for(int byte=0; byte<sizes[field]; byte++){
+      buffer[offsets[field]+byte] = (fields[field] >> (8*byte)) & 0xFF;
+    }
+  }
+
+  for(size_t record=0; record<records.size(); record++){                              //records, every field lowest byte first
+    unsigned long long values[3] = {records[record].key, records[record].occurrence, records[record].code};
+    unsigned char *data = &buffer[32+24*record];
+    for(int field=0; field<3; field++){
+      for(int byte=0; byte<8; byte++){
+        data[8*field+byte] = (values[field] >> (8*byte)) & 0xFF;
+      }
+    }
+  }
+
+  string partial = filename+".partial";
+  ofstream file(partial.c_str(), ios::binary);
+  file.write((const char*)&buffer[0], buffer.size());
+  return finish_partial_file(file, partial, filename);
+}
+
+
+
+//open_shard_file opens the shard file filename and reads its header, so that file is left at the first record and amount holds the amount of records. It returns FALSE if the file cannot be opened, if
+//its header is wrong or does not belong to shard of shards of the alkane with CarbonAmount carbon atoms, or if the file is too short to hold all records.
+
+bool open_shard_file(string filename, int CarbonAmount, int shard, int shards, ifstream &file, long long &amount){
+  file.open(filename.c_str(), ios::binary);
+  unsigned char header[32];
+  if(!file.read((char*)header, 32)) {
+    return false;
+  }
+
+  unsigned long long fields[5] = {0, 0, 0, 0, 0};
+  int offsets[5] = {8, 12, 16, 24, 28};
+  int sizes[5]   = {4, 4, 8, 4, 4};
+  for(int field=0; field<5; field++){
+    for(int byte=0; byte<sizes[field]; byte++){
+      fields[field] |= (unsigned long long)header[offsets[field]+byte] << (8*byte);
+    }
+  }
+  amount = fields[2];
+
+  file.seekg(0, ios::end);                                                            //check the length of the file and return to the first record
+  long long size = file.tellg();
+  file.seekg(32);
+
+  return memcmp(header, "ALKSHARD", 8)==0 && fields[0]==1 && (int)fields[1]==CarbonAmount && (int)fields[3]==shard && (int)fields[4]==shards &&
+         size==32+24*amount;
+}
+
+
+
+//read_shard_record reads the next record of a shard file opened by open_shard_file into record. FALSE is returned if the file ends before the record is complete.
+
+bool read_shard_record(ifstream &file, shard_record &record){
+  unsigned char data[24];
+  if(!file.read((char*)data, 24)) {
+    return false;
+  }
+
+  unsigned long long values[3] = {0, 0, 0};
+  for(int field=0; field<3; field++){
+    for(int byte=0; byte<8; byte++){
+      values[field] |= (unsigned long long)data[8*field+byte] << (8*byte);
+    }
+  }
+  record.key = values[0];
+  record.occurrence = values[1];
+  record.code = values[2];
+  return true;
+}
+
+
+
+//shard_filename returns the name of shard file number shard of shards of the alkane with CarbonAmount carbon atoms in directory
+
+string shard_filename(string directory, int CarbonAmount, int shard, int shards){
+  return directory+"/"+to_string(CarbonAmount)+".shard-"+to_string(shard)+"-of-"+to_string(shards);
+}
+
+
+
+//PROGRESS FUNCTION GROUP
+
+//report_progress prints a line on stderr every progressSeconds seconds until progress.done is set, which wakes it up right away: the share of parent isomers extended so far, the rate of extensions tried, the shares of
+//extensions rejected by the validity check and as duplicates, the unique isomers stored after the last wave, the load of the shard indexes and the estimated time until the alkane is finished. The
+//estimate assumes that the remaining parents take as long as the ones extended so far.
+
+void report_progress(level_progress &progress){
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  chrono::steady_clock::time_point next_report = start;
+
+  while(true) {
+    next_report += chrono::seconds(progressSeconds);
+    {
+      unique_lock<mutex> guard(progress.lock);
+      if(progress.finished.wait_until(guard, next_report, [&]{ return progress.done; })) {
+        return;
+      }
+    }
+    double seconds = seconds_since(start);
+
+    long long parents = 0, extensions = 0, invalid = 0, duplicates = progress.merge_duplicates;
+    for(int worker=0; worker<(int)progress.workers.size(); worker++){
+      parents += progress.workers[worker].parents;
+      extensions += progress.workers[worker].extensions;
+      invalid += progress.workers[worker].invalid;
+      duplicates += progress.workers[worker].duplicates;
+    }
+    double done = (double)parents/max(1LL, progress.parents);
+    double shown = max(1LL, extensions);
+
+    cerr << "C" << progress.carbons << ": " << parents << "/" << progress.parents << " parents (" << fixed << setprecision(1) << 100*done << "%), "
+         << setprecision(0) << extensions/seconds << " extensions/s, "
+         << setprecision(1) << 100*invalid/shown << "% invalid, " << 100*duplicates/shown << "% duplicates, "
+         << progress.stored << " isomers stored, index load " << setprecision(2) << (double)progress.used_slots/max(1LL, (long long)progress.slots) << ", ETA ";
+    if(parents>0) {
+      cerr << setprecision(0) << seconds*(1-done)/done << " s" << endl;
+    } else {
+      cerr << "unknown" << endl;
+    }
+  }
+}
+
+
+
+//print_trace writes one line with the time taken by every step of generate_Isomers for the alkane with CarbonAmount carbon atoms and amount isomers to trace, as JSON object. seconds is the time
+//the whole alkane took.
+
+void print_trace(ofstream &trace, int CarbonAmount, long long amount, morgan_index &statistics, double seconds){
+  trace << "{\"carbons\": " << CarbonAmount << ", \"isomers\": " << amount << fixed << setprecision(6)
+        << ", \"seconds\": " << seconds << ", \"generate_seconds\": " << statistics.generate_seconds
+        << ", \"key_seconds\": " << statistics.key_seconds << ", \"lookup_seconds\": " << statistics.lookup_seconds
+        << ", \"merge_seconds\": " << statistics.merge_seconds << ", \"store_seconds\": " << statistics.store_seconds << ", \"describe_seconds\": " << statistics.describe_seconds
+        << ", \"extensions\": " << statistics.extensions << ", \"invalid\": " << statistics.invalid
+        << ", \"duplicates\": " << statistics.duplicates << ", \"peak_memory_kb\": " << peak_memory() << "}" << endl;
+}
+
+
+
+//BENCHMARK FUNCTION GROUP
+
+//benchmark_Isomers generates all alkanes from methane to lastCarbon with the settings given on the command line and prints, as a single JSON object, how long every alkane took and how much work
+//it was: the extensions tried, the candidates and duplicates found at each step (see struct morgan_index), the time of every step of generate_Isomers and the peak memory use so far. The time spent
+//generating the chunks is also split into the time taken by the keys and by the lookups within the chunks, which are summed over all threads. Every amount of isomers is compared with the amount
+//count_alkanes computes, which is the OEIS sequence A000602, so a faster but wrong version of the program cannot go unnoticed. Alkanes smaller than firstCarbon are generated, but not reported. No files are written. Returns 0 if all amounts are correct and 1 otherwise, so it can be used as exit status.
+
+int benchmark_Isomers(){
+  vector<big_number> rooted;
+  count_rooted_trees(rooted, lastCarbon);
+
+  vector<isomer_code> current(1, 0);                                                  //methane
+  isomer_level parents;
+  level_from_codes(parents, current);
+  bool correct = true;
+  chrono::steady_clock::time_point run_start = chrono::steady_clock::now();
+
+  cout << "{" << endl;
+  cout << "  \"threads\": " << worker_count() << "," << endl;
+  cout << "  \"key_mode\": \"" << (keyMode==canonicalKeys ? "canonical" : "morgan") << "\"," << endl;
+  cout << "  \"batch_morgans\": " << ((keyMode==morganKeys && batchMorgans && morgans_batch_supported()) ? "true" : "false") << "," << endl;
+  cout << "  \"levels\": [";
+
+  bool first_level = true;
+  for(int CarbonAmount=2; CarbonAmount<=lastCarbon; CarbonAmount++){
+    morgan_index statistics;
+    morgan_index_init(statistics, 1);
+    unsigned long long expected = big_to_integer(count_alkanes(rooted, CarbonAmount));
+
+    chrono::steady_clock::time_point level_start = chrono::steady_clock::now();
+    current.reserve(expected);
+    generate_Isomers(parents, current, CarbonAmount, keyMode, statistics, NULL);
+    double seconds = seconds_since(level_start);
+
+    bool level_correct = (current.size()==expected);
+    correct = correct && level_correct;
+
+    if(CarbonAmount>=firstCarbon) {
+      long long candidates = statistics.extensions-statistics.invalid;
+      cout << (first_level ? "" : ",") << endl;
+      cout << "    {\"carbons\": " << CarbonAmount << ", \"isomers\": " << current.size() << ", \"expected\": " << expected
+           << ", \"correct\": " << (level_correct ? "true" : "false") << "," << endl;
+      cout << "     \"seconds\": " << fixed << setprecision(6) << seconds << ", \"generate_seconds\": " << statistics.generate_seconds
+           << ", \"key_seconds\": " << statistics.key_seconds << ", \"lookup_seconds\": " << statistics.lookup_seconds
+           << ", \"merge_seconds\": " << statistics.merge_seconds << ", \"store_seconds\": " << statistics.store_seconds << "," << endl;
+      cout << "     \"extensions\": " << statistics.extensions << ", \"invalid\": " << statistics.invalid << ", \"candidates\": " << candidates
+           << ", \"duplicates_in_chunk\": " << statistics.duplicates-statistics.merge_duplicates << ", \"duplicates_across_chunks\": " << statistics.merge_duplicates << "," << endl;
+      cout << "     \"lookups\": " << statistics.lookups << ", \"probes\": " << statistics.probes << ", \"collisions\": " << statistics.collisions
+           << ", \"filtered\": " << statistics.filtered << ", \"peak_memory_kb\": " << peak_memory() << "}";
+      first_level = false;
+    }
+
+    release_level(parents);
+    level_from_codes(parents, current);
+  }
+  release_level(parents);
+
+  cout << endl << "  ]," << endl;
+  cout << "  \"total_seconds\": " << fixed << setprecision(6) << seconds_since(run_start) << "," << endl;
+  cout << "  \"peak_memory_kb\": " << peak_memory() << "," << endl;
+  cout << "  \"correct\": " << (correct ? "true" : "false") << endl;
+  cout << "}" << endl;
+  return correct ? 0 : 1;
+}
+
+
+
+//seconds_since returns the seconds passed since start
+
+double seconds_since(chrono::steady_clock::time_point start){
+  return chrono::duration<double>(chrono::steady_clock::now()-start).count();
+}
+
+
+
+//peak_memory returns the largest amount of memory the program has used so far in kB (the peak resident set size)
+
+long peak_memory(){
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+
+
+//COUNT FUNCTION GROUP
+
+//count_Isomers computes the amounts of isomers from methane to lastCarbon without generating a single isomer, using Polya's counting theorem on the branches of the alkanes as Cayley and Polya did
+//(see functions count_rooted_trees and count_alkanes). This takes a few milliseconds even for hectane. If verify is set, the isomers up to countCheckCarbon are also generated by generate_Isomers and
+//both amounts are compared, and FALSE is returned if they differ for any alkane.
+
+bool count_Isomers(bool verify){
+  int last = lastCarbon;
+  vector<big_number> rooted;
+  count_rooted_trees(rooted, last);
+
+  vector<isomer_code> current(1, 0);                                                  //generated isomers for verify, starting at methane
+  isomer_level parents;
+  level_from_codes(parents, current);
+  bool verified = true;
+
+  cout << endl;
+  cout << "n \t" << "#isomers" << endl;
+  cout << "____________________________________" << endl;
+
+  for(int CarbonAmount=1; CarbonAmount<=last; CarbonAmount++){
+    big_number amount = count_alkanes(rooted, CarbonAmount);
+    bool printed = CarbonAmount>=firstCarbon;
+    if(printed) {
+      cout << CarbonAmount << " \t" << big_to_string(amount);
+    }
+
+    if(verify && CarbonAmount<=countCheckCarbon) {                                    //generate the isomers of this alkane and compare their amount
+      if(CarbonAmount>1) {
+        morgan_index statistics;
+        morgan_index_init(statistics, 1);
+        generate_Isomers(parents, current, CarbonAmount, keyMode, statistics, NULL);
+        level_from_codes(parents, current);
+      }
+      big_number generated = big_from(parents.amount);
+      if(generated.limbs!=amount.limbs) {
+        verified = false;
+      }
+      if(printed) {
+        cout << " \tgenerated: " << parents.amount << (generated.limbs==amount.limbs ? "" : " MISMATCH");
+      }
+    }
+    if(printed) {
+      cout << endl;
+    }
+  }
+
+  if(verify) {
+    cout << (verified ? "All counts match the generated isomers." : "Some counts do NOT match the generated isomers.") << endl;
+  }
+  return verified;
+}
+
+
+
+//count_rooted_trees computes rooted[k], the amount of different branches with k carbon atoms (k=0...last), where a branch is a tree hanging from its first atom and every atom may have up to 3 further
+//atoms attached. The empty branch is counted as rooted[0]=1. A branch of k atoms consists of its first atom and an unordered selection of 3 branches with k-1 atoms in total. By Polya's theorem with the
+//cycle index of the symmetric group S3, the amount of such selections is the coefficient of x^(k-1) in
+//  (T(x)^3 + 3*T(x)*T(x^2) + 2*T(x^3)) / 6,      where T(x) = rooted[0] + rooted[1]*x + rooted[2]*x^2 + ...
+//As this coefficient only uses rooted[0...k-1], all amounts can be computed one after the other. The coefficients of T(x)^2 are kept to obtain those of T(x)^3 in linear time.
+
+void count_rooted_trees(vector<big_number> &rooted, int last){
+  vector<big_number> squares;                                                         //coefficients of T(x)^2
+  rooted.assign(1, big_from(1));
+
+  for(int k=1; k<=last; k++){
+    int n = k-1;                                                                      //atoms to distribute over the 3 branches
+    big_number square;                                                                //coefficient of x^n in T(x)^2, now that rooted[0...n] is known
+    for(int i=0; i<=n; i++){
+      big_number product = big_multiply(rooted[i], rooted[n-i]);
+      square = big_add(square, product);
+    }
+    squares.push_back(square);
+
+    big_number sum;
+    for(int i=0; i<=n; i++){                                                          //T(x)^3
+      big_number product = big_multiply(rooted[i], squares[n-i]);
+      sum = big_add(sum, product);
+    }
+    for(int j=0; 2*j<=n; j++){                                                        //3*T(x)*T(x^2)
+      big_number product = big_multiply(rooted[n-2*j], rooted[j]);
+      product = big_multiply_small(product, 3);
+      sum = big_add(sum, product);
+    }
+    if(n%3==0) {                                                                      //2*T(x^3)
+      big_number product = big_multiply_small(rooted[n/3], 2);
+      sum = big_add(sum, product);
+    }
+    unsigned int remainder;
+    rooted.push_back(big_divide_small(sum, 6, remainder));
+  }
+}
+
+
+
+//count_alkanes computes the amount of isomers of the alkane with CarbonAmount carbon atoms from the amounts of branches in rooted. Every tree has either a single centroid, an atom whose branches all have
+//at most (CarbonAmount-1)/2 atoms, or two bonded centroids whose halves have exactly CarbonAmount/2 atoms each. Trees with a single centroid consist of the centroid and an unordered selection of 4
+//branches with CarbonAmount-1 atoms in total, each of at most m=(CarbonAmount-1)/2 atoms. With the cycle index of S4, their amount is the coefficient of x^(CarbonAmount-1) in
+//  (B(x)^4 + 6*B(x)^2*B(x^2) + 3*B(x^2)^2 + 8*B(x)*B(x^3) + 6*B(x^4)) / 24,      where B(x) = rooted[0] + rooted[1]*x + ... + rooted[m]*x^m
+//Trees with two centroids are unordered pairs of branches with CarbonAmount/2 atoms, of which there are rooted[CarbonAmount/2]*(rooted[CarbonAmount/2]+1)/2.
+
+big_number count_alkanes(vector<big_number> &rooted, int CarbonAmount){
+  int n = CarbonAmount-1;                                                             //atoms to distribute over the 4 branches of the centroid
+  int m = n/2;                                                                        //largest branch allowed
+  vector<big_number> branch(rooted.begin(), rooted.begin()+m+1);                      //coefficients of B(x)
+  branch.resize(n+1);
+
+  vector<big_number> squares(n+1);                                                    //coefficients of B(x)^2 up to x^n
+  for(int i=0; i<=m; i++){
+    for(int j=0; j<=m && i+j<=n; j++){
+      big_number product = big_multiply(branch[i], branch[j]);
+      squares[i+j] = big_add(squares[i+j], product);
+    }
+  }
+
+  big_number sum;
+  for(int i=0; i<=n; i++){                                                            //B(x)^4
+    big_number product = big_multiply(squares[i], squares[n-i]);
+    sum = big_add(sum, product);
+  }
+  for(int j=0; 2*j<=n; j++){                                                          //6*B(x)^2*B(x^2)
+    big_number product = big_multiply(squares[n-2*j], branch[j]);
+    product = big_multiply_small(product, 6);
+    sum = big_add(sum, product);
+  }
+  if(n%2==0) {                                                                        //3*B(x^2)^2
+    big_number product = big_multiply_small(squares[n/2], 3);
+    sum = big_add(sum, product);
+  }
+  for(int j=0; 3*j<=n; j++){                                                          //8*B(x)*B(x^3)
+    big_number product = big_multiply(branch[n-3*j], branch[j]);
+    product = big_multiply_small(product, 8);
+    sum = big_add(sum, product);
+  }
+  if(n%4==0) {                                                                        //6*B(x^4)
+    big_number product = big_multiply_small(branch[n/4], 6);
+    sum = big_add(sum, product);
+  }
+  unsigned int remainder;
+  big_number amount = big_divide_small(sum, 24, remainder);
+
+  if(CarbonAmount%2==0) {                                                             //add the trees with two centroids
+    big_number half = rooted[CarbonAmount/2];
+    big_number one = big_from(1);
+    big_number half_plus_one = big_add(half, one);
+    big_number pairs = big_multiply(half, half_plus_one);
+    pairs = big_divide_small(pairs, 2, remainder);
+    amount = big_add(amount, pairs);
+  }
+  return amount;
+}
+
+
+
+//BIG NUMBER FUNCTION GROUP
+
+//big_from creates a big_number of the given value
+
+big_number big_from(unsigned long long value){
+  big_number number;
+  while(value>0) {
+    number.limbs.push_back(value & 0xFFFFFFFFULL);
+    value >>= 32;
+  }
+  return number;
+}
+
+
+
+//big_add returns first+second, adding digit by digit with carry
+
+big_number big_add(big_number &first, big_number &second){
+  big_number sum;
+  unsigned long long carry = 0;
+  size_t length = max(first.limbs.size(), second.limbs.size());
+
+  for(size_t digit=0; digit<length || carry>0; digit++){
+    unsigned long long value = carry;
+    if(digit<first.limbs.size())  value += first.limbs[digit];
+    if(digit<second.limbs.size()) value += second.limbs[digit];
+    sum.limbs.push_back(value & 0xFFFFFFFFULL);
+    carry = value >> 32;
+  }
+  return sum;
+}
+
+
+
+//big_multiply returns first*second using schoolbook multiplication, which is fast enough for the few digits the isomer counts have
+
+big_number big_multiply(big_number &first, big_number &second){
+  big_number product;
+  if(first.limbs.empty() || second.limbs.empty()) {
+    return product;
+  }
+  product.limbs.assign(first.limbs.size()+second.limbs.size(), 0);
+
+  for(size_t i=0; i<first.limbs.size(); i++){
+    unsigned long long carry = 0;
+    for(size_t j=0; j<second.limbs.size(); j++){
+      unsigned long long value = (unsigned long long)first.limbs[i]*second.limbs[j] + product.limbs[i+j] + carry;
+      product.limbs[i+j] = value & 0xFFFFFFFFULL;
+      carry = value >> 32;
+    }
+    product.limbs[i+second.limbs.size()] = carry;
+  }
+  while(!product.limbs.empty() && product.limbs.back()==0) {
+    product.limbs.pop_back();
+  }
+  return product;
+}
+
+
+
+//big_multiply_small returns number*factor
+
+big_number big_multiply_small(big_number &number, unsigned int factor){
+  big_number small = big_from(factor);
+  return big_multiply(number, small);
+}
+
+
+
+//big_divide_small returns number/divisor and stores the remainder in remainder. Starting at the highest digit, the remainder of each digit is carried over to the next lower one.
+
+big_number big_divide_small(big_number &number, unsigned int divisor, unsigned int &remainder){
+  big_number quotient;
+  quotient.limbs.assign(number.limbs.size(), 0);
+  unsigned long long carry = 0;
+
+  for(int digit=(int)number.limbs.size()-1; digit>=0; digit--){
+    unsigned long long value = (carry << 32) | number.limbs[digit];
+    quotient.limbs[digit] = value / divisor;
+    carry = value % divisor;
+  }
+  remainder = carry;
+  while(!quotient.limbs.empty() && quotient.limbs.back()==0) {
+    quotient.limbs.pop_back();
+  }
+  return quotient;
+}
+
+
+
+//big_to_integer returns number as a 64 bit integer. Only the lowest 64 bits are kept, so number has to be smaller than 2^64.
+
+unsigned long long big_to_integer(big_number number){
+  unsigned long long value = 0;
+  for(int digit=min((int)number.limbs.size(), 2)-1; digit>=0; digit--){
+    value = (value << 32) | number.limbs[digit];
+  }
+  return value;
+}
+
+
+
+//big_to_string returns the decimal representation of number by repeatedly dividing by 10^9 and writing the remainders from the lowest to the highest
+
+string big_to_string(big_number number){
+  if(number.limbs.empty()) {
+    return "0";
+  }
+
+  string text;
+  while(!number.limbs.empty()) {
+    unsigned int remainder;
+    big_number quotient = big_divide_small(number, 1000000000, remainder);
+
+    string block = to_string(remainder);
+    if(!quotient.limbs.empty()) {                                                     //all blocks but the highest are padded to 9 decimal digits
+      block = string(9-block.size(), '0') + block;
+    }
+    text = block + text;
+    number = quotient;
+  }
+  return text;
+}
+
+
+
+//INDEX FUNCTION GROUP
+
+//morgan_index_init creates an empty index with capacity slots. The capacity has to be a power of 2.
+
+void morgan_index_init(morgan_index &index, int capacity){
+  index.slots.assign(capacity, -1);
+  index.hashes.assign(capacity, 0);
+  index.used = 0;
+  index.lookups = 0;
+  index.probes = 0;
+  index.collisions = 0;
+  index.filtered = 0;
+  index.duplicates = 0;
+  index.extensions = 0;
+  index.invalid = 0;
+  index.merge_duplicates = 0;
+  index.generate_seconds = 0;
+  index.key_seconds = 0;
+  index.lookup_seconds = 0;
+  index.merge_seconds = 0;
+  index.store_seconds = 0;
+  index.describe_seconds = 0;
+}
+
+
+
+//morgan_index_grow doubles the amount of slots of the index and reinserts all stored isomers. As the hash of every stored code is kept, the codes themselves do not have to be hashed again.
+
+void morgan_index_grow(morgan_index &index){
+  vector<int> old_slots;
+  vector<unsigned long long> old_hashes;
+  old_slots.swap(index.slots);
+  old_hashes.swap(index.hashes);
+
+  index.slots.assign(2*old_slots.size(), -1);
+  index.hashes.assign(2*old_slots.size(), 0);
+  int mask = index.slots.size()-1;
+
+  for(int old_slot=0; old_slot<(int)old_slots.size(); old_slot++){                                           //reinsert every occupied slot at its new position
+    if(old_slots[old_slot]!=-1){
+      int slot = old_hashes[old_slot] & mask;
+      while(index.slots[slot]!=-1){
+        slot = (slot+1) & mask;
+      }
+      index.slots[slot] = old_slots[old_slot];
+      index.hashes[slot] = old_hashes[old_slot];
+    }
+  }
+}
+
+
+
+//morgan_index_add_statistics adds the counters of part to those of total, together with the time spent on the keys and lookups of a chunk
+
+void morgan_index_add_statistics(morgan_index &total, morgan_index &part){
+  total.lookups += part.lookups;
+  total.probes += part.probes;
+  total.collisions += part.collisions;
+  total.filtered += part.filtered;
+  total.duplicates += part.duplicates;
+  total.extensions += part.extensions;
+  total.invalid += part.invalid;
+  total.merge_duplicates += part.merge_duplicates;
+  total.key_seconds += part.key_seconds;
+  total.lookup_seconds += part.lookup_seconds;
+}
+
+
+
+//morgan_hash combines all values of the sorted Morgan's code of an isomer into a single 64 bit hash. Every value is mixed into the hash by a multiplication with a large odd constant and a xor-shift, so that
+//codes only differing in a single value end up in different slots.
+
+unsigned long long morgan_hash(int CarbonAmount, int morgan[]){
+  unsigned long long hash = CarbonAmount;
+
+  for(int digit=1; digit<=CarbonAmount; digit++){
+    hash = (hash ^ (unsigned long long)morgan[digit]) * 0x9E3779B97F4A7C15ULL;
+    hash ^= hash >> 29;
+  }
+  return hash;
+}
+
+
+
+//UI FUNCTION GROUP
+
+//read_options reads the command line options into firstCarbon, lastCarbon, outputFormat, outputDirectory, threadCount, showProgress, traceFilename, descriptorSet, keyMode, crossCheckKeys, engine,
+//spillParents and checkpointLevels, or into the flags of main (count_only, verify, benchmark and resume_directory). generate_files is set to 1 or 0 if --output chose whether files are written and is
+//left alone otherwise. --shard I/N sets shard to I and shards to N, --merge-shards N sets merge_shards to N; both are left alone if not given. With --count-only, lastCarbon is countLastCarbon unless
+//--last is given. FALSE is returned if an option is unknown, lacks its value or is out of range, or if --count-only is combined with an option that generates isomers in a different way.
+
+bool read_options(int argc, char *argv[], bool &count_only, bool &verify, bool &benchmark, string &resume_directory, int &generate_files, int &shard, int &shards, int &merge_shards){
+  bool last_given = false;
+  bool engine_given = false;
+
+  for(int argument=1; argument<argc; argument++){
+    string option = argv[argument];
+    string value = (argument+1<argc) ? argv[argument+1] : "";
+    bool has_value = argument+1<argc;
+
+    if(option=="--count-only") {
+      count_only = true;
+    } else if(option=="--verify") {
+      verify = true;
+    } else if(option=="--cross-check") {
+      crossCheckKeys = true;
+    } else if(option=="--keys" && (value=="canonical" || value=="morgan")) {
+      keyMode = (value=="morgan") ? morganKeys : canonicalKeys;
+      argument++;
+    } else if(option=="--no-checkpoint") {
+      checkpointLevels = false;
+    } else if(option=="--spill") {
+      spillParents = true;
+    } else if(option=="--engine" && (value=="store" || value=="orderly")) {
+      engine = (value=="orderly") ? orderlyEngine : storeEngine;
+      engine_given = true;
+      argument++;
+    } else if(option=="--benchmark") {
+      benchmark = true;
+    } else if(option=="--progress") {
+      showProgress = true;
+    } else if(option=="--trace" && has_value) {
+      traceFilename = value;
+      argument++;
+    } else if(option=="--resume-from" && has_value) {
+      resume_directory = value;
+      argument++;
+    } else if(option=="--first" && has_value && read_number(value, firstCarbon)) {
+      argument++;
+    } else if(option=="--last" && has_value && read_number(value, lastCarbon)) {
+      last_given = true;
+      argument++;
+    } else if(option=="--threads" && has_value && read_number(value, threadCount)) {
+      argument++;
+    } else if(option=="--shard" && value.find('/')!=string::npos &&
+              read_number(value.substr(0, value.find('/')), shard) && read_number(value.substr(value.find('/')+1), shards)) {
+      argument++;
+    } else if(option=="--merge-shards" && has_value && read_number(value, merge_shards)) {
+      argument++;
+    } else if(option=="--descriptors" && has_value && read_descriptor_set(value, descriptorSet)) {
+      argument++;
+    } else if(option=="--output-dir" && has_value) {
+      outputDirectory = value;
+      argument++;
+    } else if(option=="--output" && (value=="text" || value=="binary" || value=="none")) {
+      generate_files = (value!="none");
+      if(value=="binary") {
+        outputFormat = binaryOutput;
+      } else if(value=="text") {
+        outputFormat = textOutput;
+      }
+      argument++;
+    } else {
+      cerr << "Unknown or incomplete option " << option << "." << endl;
+      return false;
+    }
+  }
+
+  if(count_only && (benchmark || shards!=0 || merge_shards!=0 || engine_given)) {                                //count_only allows alkanes beyond maxCodeCarbons, which nothing else can generate
+    cerr << "--count-only cannot be combined with --benchmark, --shard, --merge-shards or --engine." << endl;
+    return false;
+  }
+  if(count_only && !last_given) {
+    lastCarbon = countLastCarbon;
+  }
+  if(firstCarbon<1 || lastCarbon<firstCarbon || (!count_only && lastCarbon>maxCodeCarbons) || threadCount<0) {
+    cerr << "The alkanes have to range from 1 to at most " << maxCodeCarbons << " carbon atoms (--first <= --last) and --threads must not be negative." << endl;
+    return false;
+  }
+  if(shard<0 || shards<0 || (shards>0 && shard>=shards) || merge_shards<0 || ((shards>0 || merge_shards>0) && lastCarbon<2)) {
+    cerr << "--shard I/N needs 0 <= I < N, --merge-shards N needs N >= 1, and both need --last to be at least 2." << endl;
+    return false;
+  }
+  return true;
+}
+
+
+
+//read_number reads the whole of text as a decimal integer into number. FALSE is returned, and number is left alone, if text is not a number.
+
+bool read_number(string text, int &number){
+  char *end;
+  long value = strtol(text.c_str(), &end, 10);
+  if(text.empty() || *end!='\0' || value<-1000000 || value>1000000) {
+    return false;
+  }
+  number = value;
+  return true;
+}
+
+
+
+//print_usage prints the command line options
+
+void print_usage(){
+  cerr << "Options:" << endl;
+  cerr << "  --first N, --last N        alkanes printed and written to files (default 1 to 20, at most " << maxCodeCarbons << ")" << endl;
+  cerr << "  --output text|binary|none  format of the isomer files, or none to write no isomer files" << endl;
+  cerr << "  --no-checkpoint            without isomer files, do not save every finished alkane to " << checkpointFilename << endl;
+  cerr << "  --output-dir DIR           directory of the isomer files (default isomer)" << endl;
+  cerr << "  --threads N                worker threads, 0 uses every core (default 0)" << endl;
+  cerr << "  --resume-from DIR          continue from the largest alkane saved in DIR" << endl;
+  cerr << "  --count-only [--verify]    only count the isomers, up to " << countLastCarbon << " carbon atoms unless --last is given" << endl;
+  cerr << "  --keys canonical|morgan    judge uniqueness by canonical codes (default) or by Morgan's codes, which use" << endl;
+  cerr << "                             AVX2 if the processor supports it" << endl;
+  cerr << "  --cross-check              generate every alkane with both key modes and compare the amounts of isomers" << endl;
+  cerr << "  --spill                    keep the previous alkane on disk instead of in memory while generating" << endl;
+  cerr << "  --engine store|orderly     store every alkane (default), or only count the isomers with a depth-first walk" << endl;
+  cerr << "                             that keeps no isomers in memory. The orderly engine writes no files" << endl;
+  cerr << "  --benchmark                time every alkane and check its amount of isomers, printed as JSON" << endl;
+  cerr << "  --progress                 report the progress of every alkane on stderr" << endl;
+  cerr << "  --trace FILE               write the time of every step of every alkane to FILE" << endl;
+  cerr << "  --shard I/N                generate shard I of N of alkane --last from the previous alkane's isomer file" << endl;
+  cerr << "  --merge-shards N           merge the N shard files of alkane --last into its isomer file and remove them" << endl;
+  cerr << "  --descriptors LIST         also write the descriptors in LIST (wiener,randic,branching,smiles or all) of every alkane" << endl;
+}
+
+
+
+//print_intro will print the introduction and, if ask is set, ask whether output files should be generated. Otherwise, FALSE is returned.
+
+bool print_intro(bool ask){
+  char answer;
+  bool boolean;
+
+  cout << endl;
+  cout << "Generation and enumeration of all alkane constitutional isomers up to C" << maxCodeCarbons << "     " << endl;
+  cout << "================================================================================" << endl;
+  cout << "by Andreas Gimpel, agimpel@student.ethz.ch                                      " << endl;
+  cout << "an entry to Prof. Philippe H. Hünenberger's challenge HS15                      " << endl;
+  cout << endl;
+  cout << "This program will enumerate the constitutional isomers from methane to C" << lastCarbon << endl;
+  if(keyMode==canonicalKeys) {
+    cout << "using a canonical representation of isomers and exact canonical labeling.      " << endl;
+  } else {
+    cout << "using a canonical representation of isomers and a modified Morgan's algorithm.  " << endl;
+  }
+  cout << "Depending on the system, computation time may exceed 1h. Termination is possible" << endl;
+  cout << "with CTRL-C. Documentation available in the attached .pdf file and the code.    " << endl;
+  cout << endl;
+  if(!ask) {
+    return 0;
+  }
+  cout << "Should all valid isomer codes be output to files to allow for reconstruction    " << endl;
+  cout << "(This will require the directory '" << outputDirectory << "' to be present)?  [y/n]" << endl;
+  cin  >> answer;
+
+  if(answer=='y') {
+    boolean=1;
+    cout << "Output will be generated in " << outputDirectory << " as [Carbon Atoms in alkane].isomers. " << endl;
+  } else if(answer=='n') {
+    boolean=0;
+    cout << "No isomer files will be generated." << endl;
+  } else {
+    cout << "No valid input. Defaulting to no isomer files." << endl;
+    boolean=0;
+  }
+  if(!boolean && checkpointLevels) {
+    cout << "Every finished alkane is still saved to " << outputDirectory << "/" << checkpointFilename << " (see --no-checkpoint)." << endl;
+  }
+  return boolean;
+}
+
+
+
+//print_structure simply prints table captions and the amount of isomers of the first alkane, which is methane unless the run was resumed from a later alkane. The amount is left out if the alkane
+//is smaller than firstCarbon.
+
+void print_structure(isomer_level &first, int CarbonAmount){
+  cout << endl;
+  cout << "n \t" << "#isomers" << endl;
+  cout << "____________________________________" << endl;
+  if(CarbonAmount>=firstCarbon) {
+    cout << CarbonAmount << " \t" << first.amount << endl;
+  }
+}
+
+
+
+//print_Isomers will ouput the amount of isomers found after each main alkane cycle as well as create the output file, if it was enabled. Alkanes smaller than firstCarbon are skipped. FALSE is
+//returned if the output file could not be written.
+
+bool print_Isomers(vector<isomer_code> &current, int CarbonAmount, morgan_index &index, bool generate_files){
+  if(CarbonAmount<firstCarbon) {
+    return true;
+  }
+
+  cout << CarbonAmount << " \t" << current.size();
+  if(indexStatistics) {                                                                                       //if enabled, add the average amount of probes per lookup and the hash collisions
+    cout << " \t" << index.probes << " probes (" << fixed << setprecision(2) << (double)index.probes/max(1LL, index.lookups) << "/lookup) \t" << index.collisions << " collisions";
+  }
+  cout << endl;
+
+  if(indexStatistics) {                                                                                       //and the share of extensions rejected by each check, from the cheapest to the most expensive
+    double extensions = max(1LL, index.extensions);
+    cout << "  \t" << index.extensions << " extensions: " << fixed << setprecision(1)
+         << 100*index.invalid/extensions << "% invalid digit, "
+         << 100*(index.duplicates-index.merge_duplicates)/extensions << "% duplicate in chunk, "
+         << 100*index.merge_duplicates/extensions << "% duplicate across chunks, "
+         << 100*(double)current.size()/extensions << "% unique";
+    if(keyMode==morganKeys) {                                                                                 //invariants are only computed along with Morgan's codes
+      cout << "; " << index.filtered << " identical hashes told apart by invariants";
+    }
+    cout << endl;
+  }
+
+  if(generate_files) {
+    return write_isomer_file(current, CarbonAmount, isomer_filename(outputDirectory, CarbonAmount));
+  }
+  return true;
+}
+
+
+
+//print_cross_check generates the current alkane a second time, using the key mode that keyMode does not use, and compares the amount of isomers found by both modes. FALSE is returned if the amounts
+//differ.
+
+bool print_cross_check(isomer_level &parents, vector<isomer_code> &current, int CarbonAmount){
+  int other_mode = (keyMode==canonicalKeys) ? morganKeys : canonicalKeys;
+  vector<isomer_code> other;
+  morgan_index statistics;
+  morgan_index_init(statistics, 1);
+
+  generate_Isomers(parents, other, CarbonAmount, other_mode, statistics, NULL);
+
+  if(other.size()==current.size()) {
+    cout << "  \tcross-check passed: " << (other_mode==canonicalKeys ? "canonical" : "Morgan's") << " codes find " << other.size() << " isomers as well" << endl;
+    return true;
+  }
+  cout << "  \tcross-check FAILED: " << (other_mode==canonicalKeys ? "canonical" : "Morgan's") << " codes find " << other.size() << " isomers" << endl;
+  return false;
+}
+
+
+
+//write_isomer_file writes all isomer codes of one alkane into filename in the format given by outputFormat. As text, every code is written as one line of digits after a short header. The lines are
+//collected in a buffer which is only written to the file once it holds about 1MB, instead of flushing the file after every line. Like binary files, text files are written under a temporary name
+//and renamed once they are complete. FALSE is returned if the file could not be written.
+
+bool write_isomer_file(vector<isomer_code> &level, int CarbonAmount, string filename){
+  if(outputFormat==binaryOutput) {
+    return write_binary_isomer_file(level.empty() ? NULL : &level[0], level.size(), CarbonAmount, filename);
+  }
+
+  string partial = filename+".partial";                                                //the file only appears under its name once it is complete
+  ofstream file(partial.c_str());
+  file << "# Carbon atoms in this alkane: " << CarbonAmount << "\n" << "# Amount of isomers found for this alkane: " << level.size() << "\n";
+
+  string buffer;
+  for(size_t z=0; z<level.size(); z++){
+    for(int y=1; y<=CarbonAmount; y++){
+      buffer += (char)('0'+isomer_digit(level[z], y));
+    }
+    buffer += '\n';
+
+    if(buffer.size() >= (1<<20)) {
+      file.write(buffer.data(), buffer.size());
+      buffer.clear();
+    }
+  }
+  file.write(buffer.data(), buffer.size());
+  return finish_partial_file(file, partial, filename);
+}
+
+
+
+//isomer_filename returns the name of the isomer file of the alkane with CarbonAmount carbon atoms in directory
+
+string isomer_filename(string directory, int CarbonAmount){
+  return directory+"/"+to_string(CarbonAmount)+".isomers";
+}